@@ -48,6 +48,7 @@
 #include "optix_visrtx.h"
 
 // clang-format off
+#define VISRTX_COMMIT_PRIORITY_ARRAY    -1
 #define VISRTX_COMMIT_PRIORITY_DEFAULT  0
 #define VISRTX_COMMIT_PRIORITY_MATERIAL 1
 #define VISRTX_COMMIT_PRIORITY_SURFACE  2
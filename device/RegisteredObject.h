@@ -59,6 +59,25 @@ struct RegisteredObject : public Object
   array_t *m_registryArray{nullptr};
 };
 
+// Slot of an object's infrequently read ("cold") GPU data in a registry side
+// table, referenced by index from the object's main registry entry
+template <typename T>
+struct RegisteredSideData
+{
+  RegisteredSideData() = default;
+  ~RegisteredSideData();
+
+  void upload(const T &data);
+
+  DeviceObjectIndex index() const;
+
+  void setRegistry(DeviceObjectArray<T> &registry);
+
+ private:
+  DeviceObjectIndex m_index{-1};
+  DeviceObjectArray<T> *m_registryArray{nullptr};
+};
+
 // Inlined definitions ////////////////////////////////////////////////////////
 
 template <typename GPU_DATA_T>
@@ -89,4 +108,32 @@ inline void RegisteredObject<GPU_DATA_T>::setRegistry(array_t &a)
     m_index = a.alloc();
 }
 
+template <typename T>
+inline RegisteredSideData<T>::~RegisteredSideData()
+{
+  if (m_registryArray)
+    m_registryArray->free(index());
+}
+
+template <typename T>
+inline void RegisteredSideData<T>::upload(const T &data)
+{
+  m_registryArray->map(index()) = data;
+  m_registryArray->unmap(index());
+}
+
+template <typename T>
+inline DeviceObjectIndex RegisteredSideData<T>::index() const
+{
+  return m_index;
+}
+
+template <typename T>
+inline void RegisteredSideData<T>::setRegistry(DeviceObjectArray<T> &a)
+{
+  m_registryArray = &a;
+  if (m_index < 0)
+    m_index = a.alloc();
+}
+
 } // namespace visrtx
@@ -44,9 +44,12 @@
 #include "scene/World.h"
 #include "scene/surface/material/sampler/Sampler.h"
 #include "scene/volume/spatial_field/SpatialField.h"
+#include "utility/OptixCacheConfig.h"
 // std
+#include <algorithm>
 #include <chrono>
 #include <cstdarg>
+#include <cstddef>
 #include <exception>
 #include <functional>
 #include <limits>
@@ -185,6 +188,7 @@ static std::map<ANARIDataType, SetParamFcn *> setParamFcns = {
     declare_param_setter_string(const char *),
     declare_param_setter(int),
     declare_param_setter(unsigned int),
+    declare_param_setter(uint64_t),
     declare_param_setter(float),
     declare_param_setter(ivec2),
     declare_param_setter(ivec3),
@@ -223,6 +227,12 @@ int VisRTXDevice::deviceImplements(const char *_extension)
     return 1;
   else if (extension == "VISRTX_CUDA_OUTPUT_BUFFERS")
     return 1;
+  else if (extension == "VISRTX_CUDA_INPUT_ARRAYS")
+    return 1;
+  else if (extension == "VISRTX_ARRAY_FILE_MAPPING")
+    return 1;
+  else if (extension == "VISRTX_NESTED_INSTANCING")
+    return 1;
 
   return 0;
 }
@@ -239,6 +249,16 @@ void VisRTXDevice::deviceSetParameter(
     setParam(id, *(int *)mem);
   else if (id == "forceInit" && type == ANARI_BOOL)
     setParam(id, *(bool *)mem);
+  else if (id == "warmUpModules" && type == ANARI_BOOL)
+    setParam(id, *(bool *)mem);
+  else if (id == "optixCache" && type == ANARI_BOOL)
+    setParam(id, *(bool *)mem);
+  else if (id == "optixCacheDir" && type == ANARI_STRING)
+    setParam(id, std::string((const char *)mem));
+  else if (id == "optixCacheSize" && type == ANARI_UINT64)
+    setParam(id, *(uint64_t *)mem);
+  else if (id == "optixCacheSize" && type == ANARI_INT32)
+    setParam(id, uint64_t(std::max(*(int *)mem, 0)));
 }
 
 void VisRTXDevice::deviceUnsetParameter(const char *id)
@@ -483,6 +503,15 @@ int VisRTXDevice::getProperty(ANARIObject object,
     } else if (prop == "version.patch" && type == ANARI_INT32) {
       writeToVoidP(mem, VISRTX_VERSION_PATCH);
       return 1;
+    } else if (prop == "startupTime" && type == ANARI_FLOAT32) {
+      writeToVoidP(mem, m_startupTime);
+      return 1;
+    } else if (prop == "blasCacheEntries" && type == ANARI_UINT64) {
+      writeToVoidP(mem, uint64_t(m_state->blasCache.numEntries()));
+      return 1;
+    } else if (prop == "blasCacheBytes" && type == ANARI_UINT64) {
+      writeToVoidP(mem, uint64_t(m_state->blasCache.bytes()));
+      return 1;
     }
   } else {
     if (mask == ANARI_WAIT)
@@ -624,13 +653,13 @@ VisRTXDevice::~VisRTXDevice()
 
   CUDA_SYNC_CHECK();
 
-  optixModuleDestroy(state.rendererModules.debug);
-  optixModuleDestroy(state.rendererModules.raycast);
-  optixModuleDestroy(state.rendererModules.ambientOcclusion);
-  optixModuleDestroy(state.rendererModules.diffusePathTracer);
-  optixModuleDestroy(state.rendererModules.scivis);
+  state.rendererModules.debug.destroy();
+  state.rendererModules.raycast.destroy();
+  state.rendererModules.ambientOcclusion.destroy();
+  state.rendererModules.diffusePathTracer.destroy();
+  state.rendererModules.scivis.destroy();
 
-  optixModuleDestroy(state.intersectionModules.customIntersectors);
+  state.intersectionModules.customIntersectors.destroy();
 
   optixDeviceContextDestroy(state.optixContext);
 
@@ -711,6 +740,8 @@ void VisRTXDevice::initDevice()
   if (m_state)
     return;
 
+  auto initStart = std::chrono::steady_clock::now();
+
   m_state = std::make_unique<DeviceGlobalState>();
   auto &state = *m_state;
 
@@ -789,56 +820,155 @@ void VisRTXDevice::initDevice()
   OPTIX_CHECK(optixDeviceContextCreate(
       state.cudaContext, &options, &state.optixContext));
 
+  // OptiX disk cache //
+
+  OptixCacheParameters cacheParams;
+  if (hasParam("optixCache"))
+    cacheParams.enabled = getParam<bool>("optixCache", true);
+  if (hasParam("optixCacheDir"))
+    cacheParams.location = getParam<std::string>("optixCacheDir", "");
+  if (hasParam("optixCacheSize"))
+    cacheParams.maxBytes = getParam<uint64_t>("optixCacheSize", 0);
+
+  const auto cache = resolveOptixCacheConfig(cacheParams,
+      getenv("VISRTX_OPTIX_CACHE_DIR"),
+      getenv("VISRTX_OPTIX_CACHE_SIZE"));
+
+  OPTIX_CHECK(
+      optixDeviceContextSetCacheEnabled(state.optixContext, cache.enabled));
+  if (cache.enabled && !cache.location.empty()) {
+    OPTIX_CHECK(optixDeviceContextSetCacheLocation(
+        state.optixContext, cache.location.c_str()));
+  }
+  if (cache.enabled && cache.highWaterMark > 0) {
+    OPTIX_CHECK(optixDeviceContextSetCacheDatabaseSizes(
+        state.optixContext, cache.lowWaterMark, cache.highWaterMark));
+  }
+
+  if (cache.enabled) {
+    std::string location(1024, '\0');
+    optixDeviceContextGetCacheLocation(
+        state.optixContext, location.data(), location.size());
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "using OptiX module cache at '%s'",
+        location.c_str());
+  } else
+    reportMessage(ANARI_SEVERITY_DEBUG, "OptiX module cache disabled");
+
   // Create OptiX modules //
 
-  auto init_module = [&](OptixModule &module, unsigned char *ptx) {
-    const std::string ptxCode = (const char *)ptx;
-
-    std::string log(2048, '\n');
-    size_t sizeof_log = log.size();
-
-    OptixModuleCompileOptions moduleCompileOptions = {};
-    moduleCompileOptions.maxRegisterCount =
-        OPTIX_COMPILE_DEFAULT_MAX_REGISTER_COUNT;
-    moduleCompileOptions.optLevel = OPTIX_COMPILE_OPTIMIZATION_DEFAULT;
-    moduleCompileOptions.debugLevel = OPTIX_COMPILE_DEBUG_LEVEL_DEFAULT;
-
-    OptixPipelineCompileOptions pipelineCompileOptions = {};
-    pipelineCompileOptions.traversableGraphFlags =
-        OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_LEVEL_INSTANCING;
-    pipelineCompileOptions.usesMotionBlur = false;
-    pipelineCompileOptions.numPayloadValues = PAYLOAD_VALUES;
-    pipelineCompileOptions.numAttributeValues = ATTRIBUTE_VALUES;
-    pipelineCompileOptions.exceptionFlags = OPTIX_EXCEPTION_FLAG_NONE;
-    pipelineCompileOptions.pipelineLaunchParamsVariableName = "frameData";
-
-    OPTIX_CHECK(optixModuleCreateFromPTX(state.optixContext,
-        &moduleCompileOptions,
-        &pipelineCompileOptions,
-        ptxCode.c_str(),
-        ptxCode.size(),
-        log.data(),
-        &sizeof_log,
-        &module));
-
-    if (sizeof_log > 1)
-      reportMessage(ANARI_SEVERITY_DEBUG, "PTX Compile Log:\n%s", log.data());
+  // Modules are compiled the first time they are needed (or in the background
+  // when warmed up), so device initialization does not pay for all of them.
+  auto init_module = [&](LazyOptixModule &module,
+                         const char *name,
+                         unsigned char *ptx) {
+    // runs on background threads for warmed up modules: messages are only
+    // collected here and reported by the thread getting the module
+    auto compile = [&state, name, ptx](
+                       uint32_t sceneFeatures) -> CompiledOptixModule {
+      CompiledOptixModule retval;
+
+      const std::string ptxCode = (const char *)ptx;
+
+      std::string log(2048, '\n');
+      size_t sizeof_log = log.size();
+
+      OptixModuleCompileOptions moduleCompileOptions = {};
+      moduleCompileOptions.maxRegisterCount =
+          OPTIX_COMPILE_DEFAULT_MAX_REGISTER_COUNT;
+      moduleCompileOptions.optLevel = OPTIX_COMPILE_OPTIMIZATION_DEFAULT;
+      moduleCompileOptions.debugLevel = OPTIX_COMPILE_DEBUG_LEVEL_DEFAULT;
+
+      // specialized variants see the scene features as a compile time
+      // constant, letting OptiX fold away the code paths of absent features
+      OptixModuleCompileBoundValueEntry boundFeatures = {};
+      if (sceneFeatures != genericSceneFeatures(sceneFeatures)) {
+        boundFeatures.pipelineParamOffsetInBytes =
+            offsetof(FrameGPUData, world.features);
+        boundFeatures.sizeInBytes = sizeof(sceneFeatures);
+        boundFeatures.boundValuePtr = &sceneFeatures;
+        boundFeatures.annotation = "sceneFeatures";
+        moduleCompileOptions.boundValues = &boundFeatures;
+        moduleCompileOptions.numBoundValues = 1;
+      }
+
+      auto pipelineCompileOptions = makePipelineCompileOptions(sceneFeatures);
+
+      retval.messages.emplace_back(ANARI_SEVERITY_DEBUG,
+          string_printf(
+              "Compiling %s (scene features 0x%x)", name, sceneFeatures));
+
+      auto start = std::chrono::steady_clock::now();
+
+      cuCtxPushCurrent(state.cudaContext);
+
+      const OptixResult res = optixModuleCreateFromPTX(state.optixContext,
+          &moduleCompileOptions,
+          &pipelineCompileOptions,
+          ptxCode.c_str(),
+          ptxCode.size(),
+          log.data(),
+          &sizeof_log,
+          &retval.module);
+
+      CUcontext ctx;
+      cuCtxPopCurrent(&ctx);
+
+      auto end = std::chrono::steady_clock::now();
+
+      if (sizeof_log > 1) {
+        retval.messages.emplace_back(ANARI_SEVERITY_DEBUG,
+            string_printf("PTX Compile Log:\n%s", log.data()));
+      }
+
+      if (res != OPTIX_SUCCESS) {
+        retval.module = nullptr;
+        retval.messages.emplace_back(ANARI_SEVERITY_FATAL_ERROR,
+            string_printf("compiling %s failed with code %s",
+                name,
+                optixGetErrorName(res)));
+      } else {
+        retval.messages.emplace_back(ANARI_SEVERITY_DEBUG,
+            string_printf("Compiled %s in %.3fs",
+                name,
+                std::chrono::duration<float>(end - start).count()));
+      }
+
+      return retval;
+    };
+
+    module.setCompileFunction(
+        compile, [this](ANARIStatusSeverity severity, const std::string &msg) {
+          reportMessage(severity, "%s", msg.c_str());
+        });
   };
 
-  reportMessage(ANARI_SEVERITY_DEBUG, "Compiling 'debug' renderer");
-  init_module(state.rendererModules.debug, Debug::ptx());
-  reportMessage(ANARI_SEVERITY_DEBUG, "Compiling 'raycast' renderer");
-  init_module(state.rendererModules.raycast, Raycast::ptx());
-  reportMessage(ANARI_SEVERITY_DEBUG, "Compiling 'ao' renderer");
-  init_module(state.rendererModules.ambientOcclusion, AmbientOcclusion::ptx());
-  reportMessage(ANARI_SEVERITY_DEBUG, "Compiling 'dpt' renderer");
+  auto &rm = state.rendererModules;
+  init_module(rm.debug, "'debug' renderer", Debug::ptx());
+  init_module(rm.raycast, "'raycast' renderer", Raycast::ptx());
+  init_module(rm.ambientOcclusion, "'ao' renderer", AmbientOcclusion::ptx());
   init_module(
-      state.rendererModules.diffusePathTracer, DiffusePathTracer::ptx());
-  reportMessage(ANARI_SEVERITY_DEBUG, "Compiling 'scivis' renderer");
-  init_module(state.rendererModules.scivis, SciVis::ptx());
+      rm.diffusePathTracer, "'dpt' renderer", DiffusePathTracer::ptx());
+  init_module(rm.scivis, "'scivis' renderer", SciVis::ptx());
+
+  auto &im = state.intersectionModules;
+  init_module(
+      im.customIntersectors, "custom intersectors", intersection_ptx());
+
+  // every renderer needs the custom intersectors
+  im.customIntersectors.warmUp();
+
+  if (getParam<bool>("warmUpModules", false)) {
+    rm.debug.warmUp();
+    rm.raycast.warmUp();
+    rm.ambientOcclusion.warmUp();
+    rm.diffusePathTracer.warmUp();
+    rm.scivis.warmUp();
+  }
 
-  reportMessage(ANARI_SEVERITY_DEBUG, "Compiling custom intersectors");
-  init_module(state.intersectionModules.customIntersectors, intersection_ptx());
+  m_startupTime = std::chrono::duration<float>(
+      std::chrono::steady_clock::now() - initStart)
+                      .count();
 }
 
 void VisRTXDevice::setCUDADevice()
@@ -191,6 +191,7 @@ struct VisRTXDevice : public anari::Device,
   int m_desiredGpuID{0};
   int m_appGpuID{-1};
   bool m_eagerInit{false};
+  float m_startupTime{0.f}; // seconds spent in initDevice()
 
   ANARIStatusCallback m_statusCB{nullptr};
   void *m_statusCBUserPtr{nullptr};
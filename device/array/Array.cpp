@@ -33,6 +33,8 @@
 // anari
 #include "anari/type_utility.h"
 #include "anari/type_utility.h"
+// std
+#include <string>
 
 namespace visrtx {
 
@@ -44,6 +46,16 @@ static void zeroOutStruct(T &v)
   std::memset(&v, 0, sizeof(T));
 }
 
+static bool isCudaDevicePointer(const void *ptr)
+{
+  cudaPointerAttributes attributes = {};
+  if (cudaPointerGetAttributes(&attributes, ptr) != cudaSuccess) {
+    cudaGetLastError(); // don't leave the error to unrelated later calls
+    return false;
+  }
+  return attributes.type == cudaMemoryTypeDevice;
+}
+
 // Array //
 
 static size_t s_numArrays = 0;
@@ -61,6 +73,9 @@ Array::Array(void *appMem,
 {
   s_numArrays++;
 
+  // file mappings must be in place before consumers in the same flush commit
+  setCommitPriority(VISRTX_COMMIT_PRIORITY_ARRAY);
+
   if (appMem) {
     m_ownership =
         deleter ? ArrayDataOwnership::CAPTURED : ArrayDataOwnership::SHARED;
@@ -80,6 +95,10 @@ Array::Array(void *appMem,
   default:
     break;
   }
+
+  // handles of object arrays are always on the host
+  if (appMem && !anari::isObject(elementType))
+    m_deviceResident = isCudaDevicePointer(appMem);
 }
 
 Array::~Array()
@@ -100,6 +119,9 @@ ArrayDataOwnership Array::ownership() const
 
 void *Array::hostData() const
 {
+  if (isDeviceResident())
+    return downloadHostData();
+
   switch (ownership()) {
   case ArrayDataOwnership::SHARED:
     return wasPrivatized() ? m_hostData.privatized.mem : m_hostData.shared.mem;
@@ -108,8 +130,12 @@ void *Array::hostData() const
     return m_hostData.captured.mem;
     break;
   case ArrayDataOwnership::MANAGED:
+    initManagedMemory();
     return m_hostData.managed.mem;
     break;
+  case ArrayDataOwnership::FILE_MAPPED:
+    return (void *)m_hostData.mapped.data();
+    break;
   default:
     break;
   }
@@ -120,10 +146,22 @@ void *Array::hostData() const
 void *Array::deviceData() const
 {
   m_usedOnDevice = true;
+  if (isDeviceResident() && !wasPrivatized())
+    return appMemory();
   uploadArrayData();
   return m_deviceData.buffer.ptr();
 }
 
+bool Array::isDeviceResident() const
+{
+  return m_deviceResident;
+}
+
+bool Array::isFileMapped() const
+{
+  return ownership() == ArrayDataOwnership::FILE_MAPPED;
+}
+
 bool Array::wasPrivatized() const
 {
   return m_privatized;
@@ -135,8 +173,12 @@ void *Array::map()
     reportMessage(ANARI_SEVERITY_WARNING,
         "array mapped again without being previously unmapped");
   }
+  if (isFileMapped()) {
+    reportMessage(ANARI_SEVERITY_WARNING,
+        "file mapped arrays are read-only, writes to them will fault");
+  }
   m_mapped = true;
-  return hostData();
+  return isDeviceResident() ? deviceData() : hostData();
 }
 
 void Array::unmap()
@@ -147,6 +189,8 @@ void Array::unmap()
     return;
   }
   m_mapped = false;
+  if (isFileMapped())
+    return; // nothing could have been written
   if (m_deviceData.buffer) {
     auto &state = *deviceState();
     state.uploadBuffer.addArray(this);
@@ -160,15 +204,44 @@ bool Array::dataModified() const
   return m_lastModified > m_lastUploaded;
 }
 
+TimeStamp Array::lastModified() const
+{
+  return m_lastModified;
+}
+
 void Array::uploadArrayData() const
 {
-  if (!m_usedOnDevice || (m_deviceData.buffer && !dataModified()))
+  if (isDeviceResident() || !m_usedOnDevice
+      || (m_deviceData.buffer && !dataModified()))
+    return;
+  if (isFileMapped()) {
+    uploadMappedFile();
+    m_lastUploaded = newTimeStamp();
     return;
+  }
   m_deviceData.buffer.upload((uint8_t *)hostData(),
       anari::sizeOf(elementType()) * totalSize());
   m_lastUploaded = newTimeStamp();
 }
 
+void Array::commit()
+{
+  if (!hasParam("file"))
+    return;
+
+  if (anari::isObject(elementType())) {
+    reportMessage(ANARI_SEVERITY_WARNING,
+        "'file' parameter is ignored on arrays of object handles");
+  } else if (isFileMapped()) {
+    reportMessage(ANARI_SEVERITY_WARNING,
+        "file mapped arrays are immutable, ignoring new 'file' parameter");
+  } else if (ownership() != ArrayDataOwnership::MANAGED) {
+    reportMessage(ANARI_SEVERITY_WARNING,
+        "'file' parameter requires arrays created without application memory");
+  } else
+    mapFile();
+}
+
 void Array::addCommitObserver(Object *obj)
 {
   m_observers.push_back(obj);
@@ -182,8 +255,42 @@ void Array::removeCommitObserver(Object *obj)
       m_observers.end());
 }
 
+void *Array::appMemory() const
+{
+  switch (ownership()) {
+  case ArrayDataOwnership::SHARED:
+    return m_hostData.shared.mem;
+  case ArrayDataOwnership::CAPTURED:
+    return m_hostData.captured.mem;
+  default:
+    break;
+  }
+
+  return nullptr;
+}
+
+void *Array::downloadHostData() const
+{
+  if (!m_downloadedData.empty() && m_lastDownloaded >= m_lastModified)
+    return m_downloadedData.data();
+
+  reportMessage(ANARI_SEVERITY_PERFORMANCE_WARNING,
+      "downloading device resident array (type '%s') for use on the host",
+      anari::toString(elementType()));
+
+  const size_t numBytes = anari::sizeOf(elementType()) * totalSize();
+  m_downloadedData.resize(numBytes);
+  cudaMemcpy(
+      m_downloadedData.data(), deviceData(), numBytes, cudaMemcpyDeviceToHost);
+  m_lastDownloaded = newTimeStamp();
+
+  return m_downloadedData.data();
+}
+
 void Array::makePrivatizedCopy(size_t numElements)
 {
+  // captured and managed data is owned by the array already, file mappings are
+  // immutable and therefore never need a private copy
   if (ownership() != ArrayDataOwnership::SHARED)
     return;
 
@@ -194,8 +301,16 @@ void Array::makePrivatizedCopy(size_t numElements)
       this->useCount(anari::RefType::INTERNAL));
 
   size_t numBytes = numElements * anari::sizeOf(elementType());
-  m_hostData.privatized.mem = malloc(numBytes);
-  std::memcpy(m_hostData.privatized.mem, m_hostData.shared.mem, numBytes);
+  if (isDeviceResident()) {
+    m_deviceData.buffer.reserve(numBytes);
+    cudaMemcpy(m_deviceData.buffer.ptr(),
+        m_hostData.shared.mem,
+        numBytes,
+        cudaMemcpyDeviceToDevice);
+  } else {
+    m_hostData.privatized.mem = malloc(numBytes);
+    std::memcpy(m_hostData.privatized.mem, m_hostData.shared.mem, numBytes);
+  }
 
   m_privatized = true;
   zeroOutStruct(m_hostData.shared);
@@ -212,13 +327,16 @@ void Array::freeAppMemory()
   } else if (ownership() == ArrayDataOwnership::MANAGED) {
     reportMessage(ANARI_SEVERITY_DEBUG, "freeing managed array");
     free(m_hostData.managed.mem);
+  } else if (ownership() == ArrayDataOwnership::FILE_MAPPED) {
+    reportMessage(ANARI_SEVERITY_DEBUG, "unmapping file backed array");
+    m_hostData.mapped.reset();
   } else if (wasPrivatized()) {
     free(m_hostData.privatized.mem);
     zeroOutStruct(m_hostData.privatized);
   }
 }
 
-void Array::initManagedMemory()
+void Array::initManagedMemory() const
 {
   if (m_hostData.managed.mem != nullptr)
     return;
@@ -226,7 +344,7 @@ void Array::initManagedMemory()
   if (ownership() == ArrayDataOwnership::MANAGED) {
     auto totalBytes = totalSize() * anari::sizeOf(elementType());
     m_hostData.managed.mem = malloc(totalBytes);
-    std::memset(hostData(), 0, totalBytes);
+    std::memset(m_hostData.managed.mem, 0, totalBytes);
   }
 }
 
@@ -239,6 +357,43 @@ void Array::notifyCommitObservers() const
   }
 }
 
+void Array::mapFile()
+{
+  const auto filename = getParam<std::string>("file", "");
+  const auto offset = getParam<uint64_t>("fileOffset", 0);
+  const size_t numBytes = anari::sizeOf(elementType()) * totalSize();
+
+  try {
+    m_hostData.mapped = MappedFile(filename, offset, numBytes);
+  } catch (const std::exception &e) {
+    reportMessage(ANARI_SEVERITY_ERROR, "%s", e.what());
+    return;
+  }
+
+  if (getParam<bool>("filePrefetch", false))
+    m_hostData.mapped.prefetch();
+
+  // nothing written to the managed memory survives, drop it
+  free(m_hostData.managed.mem);
+  zeroOutStruct(m_hostData.managed);
+
+  m_ownership = ArrayDataOwnership::FILE_MAPPED;
+  m_lastModified = newTimeStamp();
+  if (m_deviceData.buffer)
+    deviceState()->uploadBuffer.addArray(this);
+  notifyCommitObservers();
+}
+
+void Array::uploadMappedFile() const
+{
+  const auto &file = m_hostData.mapped;
+  m_deviceData.buffer.reserve(file.size());
+  file.forEachChunk(MappedFile::DEFAULT_CHUNK_BYTES,
+      [&](const uint8_t *chunk, size_t offset, size_t numBytes) {
+        m_deviceData.buffer.upload(chunk, numBytes, offset);
+      });
+}
+
 } // namespace visrtx
 
 VISRTX_ANARI_TYPEFOR_DEFINITION(visrtx::Array *);
@@ -33,6 +33,7 @@
 
 #include "utility/DeviceBuffer.h"
 #include "utility/DeviceObject.h"
+#include "utility/MappedFile.h"
 // std
 #include <vector>
 // thrust
@@ -55,6 +56,7 @@ enum class ArrayDataOwnership
   SHARED,
   CAPTURED,
   MANAGED,
+  FILE_MAPPED,
   INVALID
 };
 
@@ -74,6 +76,14 @@ struct Array : public Object
   void *hostData() const;
   void *deviceData() const override;
 
+  // Application memory which is a CUDA device allocation is used on the device
+  // as is, hostData() then returns a copy downloaded on demand
+  bool isDeviceResident() const;
+
+  // Arrays created without application memory can instead be backed by a
+  // read-only mapping of a file, set up by the "file" parameter on commit
+  bool isFileMapped() const;
+
   template <typename T>
   T *hostDataAs() const;
 
@@ -91,15 +101,20 @@ struct Array : public Object
   void unmap();
 
   bool dataModified() const;
+  TimeStamp lastModified() const;
   virtual void uploadArrayData() const;
 
+  void commit() override;
+
   void addCommitObserver(Object *obj);
   void removeCommitObserver(Object *obj);
 
  protected:
+  void *appMemory() const;
+  void *downloadHostData() const;
   void makePrivatizedCopy(size_t numElements);
   void freeAppMemory();
-  void initManagedMemory();
+  void initManagedMemory() const;
 
   struct ArrayDescriptor
   {
@@ -118,7 +133,10 @@ struct Array : public Object
     struct ManagedData
     {
       void *mem{nullptr};
-    } managed;
+    };
+    mutable ManagedData managed; // allocated on first use
+
+    MappedFile mapped;
 
     struct PrivatizedData
     {
@@ -131,17 +149,23 @@ struct Array : public Object
     mutable DeviceBuffer buffer;
   } m_deviceData;
 
+  mutable std::vector<uint8_t> m_downloadedData; // device resident arrays
+
   TimeStamp m_lastModified{0};
   mutable TimeStamp m_lastUploaded{0};
+  mutable TimeStamp m_lastDownloaded{0};
 
  private:
   void notifyCommitObservers() const;
+  void mapFile();
+  void uploadMappedFile() const;
 
   std::vector<Object *> m_observers;
 
   ArrayDataOwnership m_ownership{ArrayDataOwnership::INVALID};
   ANARIDataType m_elementType{ANARI_UNKNOWN};
   bool m_privatized{false};
+  bool m_deviceResident{false};
   bool m_mapped{false};
   mutable bool m_usedOnDevice{false};
 };
@@ -43,7 +43,6 @@ Array1D::Array1D(void *appMemory,
 {
   if (byteStride != 0)
     throw std::runtime_error("strided arrays not yet supported!");
-  initManagedMemory();
 }
 
 ArrayShape Array1D::shape() const
@@ -48,8 +48,6 @@ Array2D::Array2D(void *appMemory,
 
   m_size[0] = numItems1;
   m_size[1] = numItems2;
-
-  initManagedMemory();
 }
 
 ArrayShape Array2D::shape() const
@@ -53,8 +53,6 @@ Array3D::Array3D(void *appMemory,
   m_size[0] = numItems1;
   m_size[1] = numItems2;
   m_size[2] = numItems3;
-
-  initManagedMemory();
 }
 
 ArrayShape Array3D::shape() const
@@ -45,6 +45,10 @@ struct Camera : public Object
 
   static Camera *createInstance(std::string_view subtype, DeviceGlobalState *d);
 
+  // Host copy of the subtype's GPU data, as uploaded by commit()
+  virtual const CameraGPUData &cameraData() const = 0;
+  virtual size_t cameraDataBytes() const = 0;
+
  protected:
   void readBaseParameters(CameraGPUData &hd);
 };
@@ -49,4 +49,14 @@ void Orthographic::commit()
   upload();
 }
 
+const CameraGPUData &Orthographic::cameraData() const
+{
+  return hostData();
+}
+
+size_t Orthographic::cameraDataBytes() const
+{
+  return sizeof(OrthographicCameraGPUData);
+}
+
 } // namespace visrtx
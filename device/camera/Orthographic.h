@@ -41,6 +41,9 @@ struct Orthographic : public DeviceObject<OrthographicCameraGPUData, Camera>
   Orthographic() = default;
 
   void commit() override;
+
+  const CameraGPUData &cameraData() const override;
+  size_t cameraDataBytes() const override;
 };
 
 } // namespace visrtx
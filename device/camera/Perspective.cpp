@@ -51,4 +51,14 @@ void Perspective::commit()
   upload();
 }
 
+const CameraGPUData &Perspective::cameraData() const
+{
+  return hostData();
+}
+
+size_t Perspective::cameraDataBytes() const
+{
+  return sizeof(PerspectiveCameraGPUData);
+}
+
 } // namespace visrtx
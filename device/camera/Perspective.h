@@ -41,6 +41,9 @@ struct Perspective : public DeviceObject<PerspectiveCameraGPUData, Camera>
   Perspective() = default;
 
   void commit() override;
+
+  const CameraGPUData &cameraData() const override;
+  size_t cameraDataBytes() const override;
 };
 
 } // namespace visrtx
@@ -32,6 +32,8 @@
 #include "Denoiser.h"
 #include "gpu/gpu_util.h"
 #include "utility/instrument.h"
+// std
+#include <algorithm>
 // thrust
 #include <thrust/device_ptr.h>
 #include <thrust/transform.h>
@@ -46,10 +48,20 @@ Denoiser::~Denoiser()
     OPTIX_CHECK(optixDenoiserDestroy(m_denoiser));
 }
 
-void Denoiser::setup(
-    uvec2 size, HostDeviceArray<uint8_t> &pixelBuffer, ANARIDataType format)
+void Denoiser::setup(uvec2 size,
+    HostDeviceArray<uint8_t> &pixelBuffer,
+    ANARIDataType format,
+    const vec3 *albedoGuide,
+    const vec3 *normalGuide)
 {
-  init();
+  if (!albedoGuide)
+    normalGuide = nullptr;
+
+  const auto kind = format == ANARI_FLOAT32_VEC4
+      ? OPTIX_DENOISER_MODEL_KIND_HDR
+      : OPTIX_DENOISER_MODEL_KIND_LDR;
+  init(kind, albedoGuide != nullptr, normalGuide != nullptr);
+
   auto &state = *deviceState();
 
   m_pixelBuffer = &pixelBuffer;
@@ -61,10 +73,13 @@ void Denoiser::setup(
       optixDenoiserComputeMemoryResources(m_denoiser, size.x, size.y, &sizes));
 
   m_state.reserve(sizes.stateSizeInBytes);
-  m_scratch.reserve(sizes.withoutOverlapScratchSizeInBytes);
+  m_scratch.reserve(std::max(sizes.withoutOverlapScratchSizeInBytes,
+      sizes.computeIntensitySizeInBytes));
+
+  const auto numPixels = size_t(size.x) * size_t(size.y);
+  m_floatPixels.resize(numPixels);
 
   if (format != ANARI_FLOAT32_VEC4) {
-    auto numPixels = size_t(size.x) * size_t(size.y);
     m_uintDevicePixels.resize(numPixels);
     m_uintMappedPixels.resize(numPixels);
   } else {
@@ -72,6 +87,14 @@ void Denoiser::setup(
     m_uintMappedPixels = {};
   }
 
+  if (kind == OPTIX_DENOISER_MODEL_KIND_HDR) {
+    m_intensity.reserve(sizeof(float));
+    m_params.hdrIntensity = (CUdeviceptr)m_intensity.ptr();
+  } else {
+    m_intensity.reset();
+    m_params.hdrIntensity = 0;
+  }
+
   OPTIX_CHECK(optixDenoiserSetup(m_denoiser,
       state.stream,
       size.x,
@@ -88,12 +111,32 @@ void Denoiser::setup(
   m_layer.input.rowStrideInBytes = 4 * sizeof(float) * size.x;
   m_layer.input.format = OPTIX_PIXEL_FORMAT_FLOAT4;
   std::memcpy(&m_layer.output, &m_layer.input, sizeof(m_layer.output));
+  m_layer.output.data = (CUdeviceptr)m_floatPixels.dataDevice();
+
+  auto makeGuide = [&](const vec3 *data) {
+    OptixImage2D image{};
+    if (data) {
+      image.data = (CUdeviceptr)data;
+      image.width = size.x;
+      image.height = size.y;
+      image.pixelStrideInBytes = 0;
+      image.rowStrideInBytes = sizeof(vec3) * size.x;
+      image.format = OPTIX_PIXEL_FORMAT_FLOAT3;
+    }
+    return image;
+  };
+
+  m_guideLayer = {};
+  m_guideLayer.albedo = makeGuide(albedoGuide);
+  m_guideLayer.normal = makeGuide(normalGuide);
 }
 
 void Denoiser::cleanup()
 {
   m_state.reset();
   m_scratch.reset();
+  m_intensity.reset();
+  m_floatPixels.clear();
   m_uintDevicePixels = {};
   m_uintMappedPixels = {};
 }
@@ -102,6 +145,17 @@ void Denoiser::launch()
 {
   auto &state = *deviceState();
 
+  if (m_modelKind == OPTIX_DENOISER_MODEL_KIND_HDR) {
+    instrument::rangePush("optixDenoiserComputeIntensity()");
+    OPTIX_CHECK(optixDenoiserComputeIntensity(m_denoiser,
+        state.stream,
+        &m_layer.input,
+        m_params.hdrIntensity,
+        (CUdeviceptr)m_scratch.ptr(),
+        m_scratch.bytes()));
+    instrument::rangePop(); // optixDenoiserComputeIntensity()
+  }
+
   instrument::rangePush("optixDenoiserInvoke()");
   OPTIX_CHECK(optixDenoiserInvoke(m_denoiser,
       state.stream,
@@ -121,7 +175,7 @@ void Denoiser::launch()
     instrument::rangePush("denoiser transform pixels");
     auto numPixels =
         size_t(m_layer.output.width) * size_t(m_layer.output.height);
-    auto begin = thrust::device_ptr<vec4>((vec4 *)m_pixelBuffer->dataDevice());
+    auto begin = thrust::device_ptr<vec4>(m_floatPixels.dataDevice());
     auto end = begin + numPixels;
     if (m_format == ANARI_UFIXED8_RGBA_SRGB) {
       thrust::transform(thrust::cuda::par.on(state.stream),
@@ -145,8 +199,8 @@ void Denoiser::launch()
 void *Denoiser::mapColorBuffer()
 {
   if (m_format == ANARI_FLOAT32_VEC4) {
-    m_pixelBuffer->download();
-    return m_pixelBuffer->dataHost();
+    m_floatPixels.download();
+    return m_floatPixels.dataHost();
   } else {
     m_uintMappedPixels = m_uintDevicePixels;
     return m_uintMappedPixels.data();
@@ -156,25 +210,30 @@ void *Denoiser::mapColorBuffer()
 void *Denoiser::mapGPUColorBuffer()
 {
   return m_format == ANARI_FLOAT32_VEC4
-      ? (void *)m_pixelBuffer->dataDevice()
+      ? (void *)m_floatPixels.dataDevice()
       : (void *)thrust::raw_pointer_cast(m_uintDevicePixels.data());
 }
 
-void Denoiser::init()
+void Denoiser::init(
+    OptixDenoiserModelKind kind, bool guideAlbedo, bool guideNormal)
 {
-  if (m_denoiser)
+  if (m_denoiser && m_modelKind == kind
+      && bool(m_options.guideAlbedo) == guideAlbedo
+      && bool(m_options.guideNormal) == guideNormal)
     return;
 
+  if (m_denoiser)
+    OPTIX_CHECK(optixDenoiserDestroy(m_denoiser));
+
   auto &state = *deviceState();
 
-  OptixDenoiserOptions options = {};
-  options.guideAlbedo = 0;
-  options.guideNormal = 0;
+  m_modelKind = kind;
+  m_options = {};
+  m_options.guideAlbedo = guideAlbedo;
+  m_options.guideNormal = guideNormal;
 
-  OPTIX_CHECK(optixDenoiserCreate(state.optixContext,
-      OPTIX_DENOISER_MODEL_KIND_LDR,
-      &options,
-      &m_denoiser));
+  OPTIX_CHECK(optixDenoiserCreate(
+      state.optixContext, m_modelKind, &m_options, &m_denoiser));
 }
 
 } // namespace visrtx
\ No newline at end of file
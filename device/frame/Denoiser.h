@@ -44,8 +44,14 @@ struct Denoiser : public Object
   Denoiser() = default;
   ~Denoiser() override;
 
-  void setup(
-      uvec2 size, HostDeviceArray<uint8_t> &pixelBuffer, ANARIDataType format);
+  // Guides are optional, normalized (not accumulated) FLOAT3 images of 'size',
+  // normals in camera space. A normal guide is only used together with an
+  // albedo guide.
+  void setup(uvec2 size,
+      HostDeviceArray<uint8_t> &pixelBuffer,
+      ANARIDataType format,
+      const vec3 *albedoGuide = nullptr,
+      const vec3 *normalGuide = nullptr);
   void cleanup();
 
   void launch();
@@ -54,21 +60,28 @@ struct Denoiser : public Object
   void *mapGPUColorBuffer();
 
  private:
-  void init();
+  void init(OptixDenoiserModelKind kind, bool guideAlbedo, bool guideNormal);
 
   // Data //
 
   ANARIDataType m_format{ANARI_UNKNOWN};
 
   OptixDenoiser m_denoiser{nullptr};
+  OptixDenoiserModelKind m_modelKind{OPTIX_DENOISER_MODEL_KIND_LDR};
+  OptixDenoiserOptions m_options{};
   OptixDenoiserParams m_params{};
   OptixDenoiserGuideLayer m_guideLayer{};
   OptixDenoiserLayer m_layer;
 
   HostDeviceArray<uint8_t> *m_pixelBuffer{nullptr};
 
+  // Denoised output is kept separate from the (noisy) pixel buffer so it stays
+  // valid until the next launch(), even if more samples are rendered.
+  HostDeviceArray<vec4> m_floatPixels;
+
   DeviceBuffer m_state;
   DeviceBuffer m_scratch;
+  DeviceBuffer m_intensity;
 
   // These buffers are only used when format != ANARI_FLOAT32_VEC4
   thrust::device_vector<uint32_t> m_uintDevicePixels;
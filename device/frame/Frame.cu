@@ -31,15 +31,95 @@
 
 #include "Frame.h"
 #include "utility/instrument.h"
+// anari
+#include "anari/type_utility.h"
 // std
 #include <algorithm>
+#include <cstdlib>
 #include <random>
 // thrust
 #include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
 #include <thrust/transform.h>
 
 namespace visrtx {
 
+// Helper types ///////////////////////////////////////////////////////////////
+
+struct UpsampleColorOp
+{
+  const vec4 *accum{nullptr};
+  const float *depth{nullptr};
+  const vec3 *normal{nullptr};
+  uvec2 srcSize;
+  uvec2 dstSize;
+  float invFrameID{1.f};
+  FrameFormat format{FrameFormat::FLOAT};
+  UpsampleFilter filter{UpsampleFilter::BILINEAR};
+  vec4 *outColorVec4{nullptr};
+  uint32_t *outColorUint{nullptr};
+
+  __device__ void operator()(uint32_t i) const
+  {
+    const uvec2 pixel(i % dstSize.x, i / dstSize.x);
+    const vec4 c = invFrameID
+        * (filter == UpsampleFilter::EDGE_AWARE
+                ? upsampleEdgeAware(
+                    accum, depth, normal, srcSize, dstSize, pixel)
+                : upsampleBilinear(accum, srcSize, dstSize, pixel));
+    if (format == FrameFormat::SRGB)
+      outColorUint[i] = cvt_uint32(glm::convertLinearToSRGB(c));
+    else if (format == FrameFormat::UINT)
+      outColorUint[i] = cvt_uint32(c);
+    else
+      outColorVec4[i] = c;
+  }
+};
+
+template <typename T>
+struct UpsampleBufferOp
+{
+  const T *src{nullptr};
+  T *dst{nullptr};
+  uvec2 srcSize;
+  uvec2 dstSize;
+  float scale{1.f};
+  bool nearest{false};
+
+  __device__ void operator()(uint32_t i) const
+  {
+    const uvec2 pixel(i % dstSize.x, i / dstSize.x);
+    dst[i] = nearest ? src[upsampleNearestIndex(srcSize, dstSize, pixel)]
+                     : scale * upsampleBilinear(src, srcSize, dstSize, pixel);
+  }
+};
+
+template <typename T>
+static void upsampleBuffer(cudaStream_t stream,
+    const T *src,
+    uvec2 srcSize,
+    T *dst,
+    uvec2 dstSize,
+    float scale,
+    bool nearest)
+{
+  if (!src || !dst)
+    return;
+
+  UpsampleBufferOp<T> op;
+  op.src = src;
+  op.dst = dst;
+  op.srcSize = srcSize;
+  op.dstSize = dstSize;
+  op.scale = scale;
+  op.nearest = nearest;
+  thrust::for_each(thrust::cuda::par.on(stream),
+      thrust::make_counting_iterator(0u),
+      thrust::make_counting_iterator(dstSize.x * dstSize.y),
+      op);
+}
+
 // Frame definitions //////////////////////////////////////////////////////////
 
 static size_t s_numFrames = 0;
@@ -79,7 +159,27 @@ void Frame::commit()
     return;
   }
 
+  m_cameras = getParamObject<ObjectArray>("cameras");
+  if (m_cameras && m_cameras->elementType() != ANARI_CAMERA) {
+    reportMessage(ANARI_SEVERITY_ERROR,
+        "'cameras' on frame must be an array of ANARI_CAMERA, not '%s'",
+        anari::toString(m_cameras->elementType()));
+    m_cameras = nullptr;
+  }
+  if (m_cameras && m_cameras->size() == 0)
+    m_cameras = nullptr;
+  m_numLayers = m_cameras ? uint32_t(m_cameras->size()) : 1;
+
+  // without 'camera', null entries of 'cameras' fall back to its first camera
   m_camera = getParamObject<Camera>("camera");
+  if (!m_camera && m_cameras) {
+    auto **cameras = (Camera **)m_cameras->handles();
+    auto *first = std::find_if(cameras,
+        cameras + m_numLayers,
+        [](Camera *c) { return c != nullptr; });
+    if (first != cameras + m_numLayers)
+      m_camera = *first;
+  }
   if (!m_camera) {
     reportMessage(
         ANARI_SEVERITY_WARNING, "missing required parameter 'camera' on frame");
@@ -93,64 +193,176 @@ void Frame::commit()
     return;
   }
 
-  m_denoise = getParam<bool>("denoise", false);
+  m_frameSize = getParam<uvec2>("size", uvec2(10));
+  m_renderSize = m_frameSize;
+
+  m_tileSize = glm::min(getParam<uvec2>("tileSize", uvec2(0)), m_frameSize);
+  m_tiled = m_tileSize.x > 0 && m_tileSize.y > 0 && m_tileSize != m_frameSize;
+  m_tileCallback = (TileCallback)getParam<void *>("tileCallback", nullptr);
+  m_tileCallbackUserData = getParam<void *>("tileCallbackUserData", nullptr);
+
+  if (m_cameras && m_tiled) {
+    reportMessage(ANARI_SEVERITY_WARNING,
+        "'tileSize' is ignored on frames with 'cameras' set");
+    m_tiled = false;
+  }
+
+  FrameConfig config;
+  config.denoise = getParam<bool>("denoise", false);
+  config.colorType = getParam<ANARIDataType>("color", ANARI_UFIXED8_RGBA_SRGB);
+  config.size = m_tiled ? m_tileSize : m_frameSize;
+  config.layers = m_numLayers;
+
+  bool checkerboard = getParam<bool>("checkerboard", false);
+  bool channelAlbedo = getParam<bool>("channelAlbedo", false);
+  bool channelNormal = getParam<bool>("channelNormal", false);
+
+  m_renderScale = std::clamp(getParam<float>("renderScale", 1.f), 0.01f, 1.f);
+  m_renderScaleInteractive = std::clamp(
+      getParam<float>("renderScaleInteractive", m_renderScale), 0.01f, 1.f);
+
+  if (m_tiled) {
+    if (config.denoise || checkerboard || channelAlbedo || channelNormal
+        || std::min(m_renderScale, m_renderScaleInteractive) < 1.f) {
+      reportMessage(ANARI_SEVERITY_WARNING,
+          "denoise, checkerboard, channelAlbedo, channelNormal and "
+          "renderScale are ignored on frames with 'tileSize' set");
+    }
+    config.denoise = false;
+    checkerboard = false;
+    channelAlbedo = false;
+    channelNormal = false;
+    m_renderScale = 1.f;
+    m_renderScaleInteractive = 1.f;
+  }
+
+  if (m_cameras) {
+    if (config.denoise
+        || std::min(m_renderScale, m_renderScaleInteractive) < 1.f) {
+      reportMessage(ANARI_SEVERITY_WARNING,
+          "denoise and renderScale are ignored on frames with 'cameras' set");
+    }
+    config.denoise = false;
+    m_renderScale = 1.f;
+    m_renderScaleInteractive = 1.f;
+  }
+
+  m_denoise = config.denoise;
 
-  auto format = getParam<ANARIDataType>("color", ANARI_UFIXED8_RGBA_SRGB);
-  const bool useFloatFB = m_denoise || format == ANARI_FLOAT32_VEC4;
+  const bool useFloatFB = config.floatColor();
   if (useFloatFB)
     hd.fb.format = FrameFormat::FLOAT;
-  else if (format == ANARI_UFIXED8_RGBA_SRGB)
+  else if (config.colorType == ANARI_UFIXED8_RGBA_SRGB)
     hd.fb.format = FrameFormat::SRGB;
   else
     hd.fb.format = FrameFormat::UINT;
 
-  hd.fb.size = getParam<uvec2>("size", uvec2(10));
+  hd.fb.size = config.size;
   hd.fb.invSize = 1.f / vec2(hd.fb.size);
 
-  const bool checkboard = getParam<bool>("checkerboard", false);
-  hd.fb.checkerboardID = checkboard ? 0 : -1;
+  auto filter = getParam<std::string>("upsampleFilter", "bilinear");
+  m_upsampleFilter = filter == "edgeAware" ? UpsampleFilter::EDGE_AWARE
+                                           : UpsampleFilter::BILINEAR;
+  if (filter != "bilinear" && filter != "edgeAware") {
+    reportMessage(ANARI_SEVERITY_WARNING,
+        "unknown upsampleFilter '%s' on frame, using 'bilinear'",
+        filter.c_str());
+  }
 
-  const bool channelDepth = getParam<bool>("channelDepth", false);
-  const bool channelAlbedo = getParam<bool>("channelAlbedo", false);
-  const bool channelNormal = getParam<bool>("channelNormal", false);
+  hd.fb.checkerboardID = checkerboard ? 0 : -1;
 
-  const auto numPixels = hd.fb.size.x * hd.fb.size.y;
+  // edge-aware upsampling needs depth + normal guides even if not mapped
+  const bool upsampleGuides = m_upsampleFilter == UpsampleFilter::EDGE_AWARE
+      && std::min(m_renderScale, m_renderScaleInteractive) < 1.f;
 
-  m_accumColor.resize(numPixels);
-  m_perPixelBytes = 4 * (useFloatFB ? 4 : 1);
-  m_pixelBuffer.resize(numPixels * m_perPixelBytes);
+  config.depthBuffer = getParam<bool>("channelDepth", false) || upsampleGuides;
+  config.albedoChannel = channelAlbedo;
+  config.normalChannel = channelNormal;
+  config.normalBuffer = config.normalChannel || upsampleGuides;
 
-  m_depthBuffer.resize(channelDepth ? numPixels : 0);
+  const auto diff = diffFrameConfigs(m_config, config);
+  m_config = config;
 
-  m_accumAlbedo.resize(channelAlbedo ? numPixels : 0);
-  m_deviceAlbedoBuffer.resize(channelAlbedo ? numPixels : 0);
-  m_mappedAlbedoBuffer.resize(channelAlbedo ? numPixels : 0);
+  const auto numPixels = config.size.x * config.size.y * config.layers;
+  m_perPixelBytes = 4 * (useFloatFB ? 4 : 1);
 
-  m_accumNormal.resize(channelNormal ? numPixels : 0);
-  m_deviceNormalBuffer.resize(channelNormal ? numPixels : 0);
-  m_mappedNormalBuffer.resize(channelNormal ? numPixels : 0);
+  // full size host images the tiles are stitched into, unless streamed out
+  const bool stitchTiles = m_tiled && !m_tileCallback;
+  const size_t numFramePixels = size_t(m_frameSize.x) * m_frameSize.y;
+  m_tiledColor.resize(stitchTiles ? numFramePixels * m_perPixelBytes : 0);
+  m_tiledDepth.resize(
+      stitchTiles && config.depthBuffer ? numFramePixels : 0);
+  m_tiledColor.shrink_to_fit();
+  m_tiledDepth.shrink_to_fit();
+
+  if (diff.colorBuffers) {
+    m_accumColor.resize(numPixels);
+    m_pixelBuffer.resize(numPixels * m_perPixelBytes);
+    m_bufferReallocations++;
+  }
 
-  hd.fb.buffers.colorAccumulation =
-      thrust::raw_pointer_cast(m_accumColor.data());
+  if (diff.depthBuffer) {
+    m_depthBuffer.resize(config.depthBuffer ? numPixels : 0);
+    m_bufferReallocations++;
+  }
 
-  hd.fb.buffers.outColorVec4 = nullptr;
-  hd.fb.buffers.outColorUint = nullptr;
+  if (diff.albedoBuffers) {
+    const auto size = config.albedoChannel ? numPixels : 0;
+    m_accumAlbedo.resize(size);
+    m_deviceAlbedoBuffer.resize(size);
+    m_mappedAlbedoBuffer.resize(size);
+    m_bufferReallocations++;
+  }
 
-  if (useFloatFB)
-    hd.fb.buffers.outColorVec4 = (vec4 *)m_pixelBuffer.dataDevice();
-  else
-    hd.fb.buffers.outColorUint = (uint32_t *)m_pixelBuffer.dataDevice();
+  if (diff.normalBuffer) {
+    m_accumNormal.resize(config.normalBuffer ? numPixels : 0);
+    m_bufferReallocations++;
+  }
 
-  hd.fb.buffers.depth = channelDepth ? m_depthBuffer.dataDevice() : nullptr;
-  hd.fb.buffers.albedo =
-      channelAlbedo ? thrust::raw_pointer_cast(m_accumAlbedo.data()) : nullptr;
-  hd.fb.buffers.normal =
-      channelNormal ? thrust::raw_pointer_cast(m_accumNormal.data()) : nullptr;
+  if (diff.normalChannelBuffers) {
+    const auto size = config.normalChannel ? numPixels : 0;
+    m_deviceNormalBuffer.resize(size);
+    m_mappedNormalBuffer.resize(size);
+    m_bufferReallocations++;
+  }
 
-  if (m_denoise)
-    m_denoiser.setup(hd.fb.size, m_pixelBuffer, format);
-  else
-    m_denoiser.cleanup();
+  hd.fb.buffers.colorAccumulation =
+      thrust::raw_pointer_cast(m_accumColor.data());
+
+  hd.fb.buffers.depth =
+      m_depthBuffer.empty() ? nullptr : m_depthBuffer.dataDevice();
+  hd.fb.buffers.albedo = m_accumAlbedo.empty()
+      ? nullptr
+      : thrust::raw_pointer_cast(m_accumAlbedo.data());
+  hd.fb.buffers.normal = m_accumNormal.empty()
+      ? nullptr
+      : thrust::raw_pointer_cast(m_accumNormal.data());
+
+  m_denoiseInterval = std::max(getParam<int>("denoiseInterval", 1), 0);
+
+  if (diff.denoiser) {
+    if (m_denoise) {
+      // guides are the normalized albedo/normal channels, if enabled
+      auto *albedoGuide = m_deviceAlbedoBuffer.empty()
+          ? nullptr
+          : thrust::raw_pointer_cast(m_deviceAlbedoBuffer.data());
+      m_normalGuide.resize(m_deviceNormalBuffer.size());
+      auto *normalGuide = m_normalGuide.empty()
+          ? nullptr
+          : thrust::raw_pointer_cast(m_normalGuide.data());
+      m_denoiser.setup(hd.fb.size,
+          m_pixelBuffer,
+          config.colorType,
+          albedoGuide,
+          normalGuide);
+      m_denoiserSetups++;
+    } else {
+      m_denoiser.cleanup();
+      m_normalGuide.clear();
+      m_normalGuide.shrink_to_fit();
+    }
+    m_denoiseDirty = m_denoise;
+  }
 
   m_frameChanged = true;
 }
@@ -171,6 +383,12 @@ bool Frame::getProperty(
     auto &hd = hostData();
     std::memcpy(ptr, &hd.fb.frameID, sizeof(hd.fb.frameID));
     return true;
+  } else if (type == ANARI_INT32 && name == "bufferReallocations") {
+    std::memcpy(ptr, &m_bufferReallocations, sizeof(m_bufferReallocations));
+    return true;
+  } else if (type == ANARI_INT32 && name == "denoiserSetups") {
+    std::memcpy(ptr, &m_denoiserSetups, sizeof(m_denoiserSetups));
+    return true;
   } else if (type == ANARI_BOOL && name == "nextFrameReset") {
     if (flags & ANARI_WAIT)
       wait();
@@ -225,6 +443,24 @@ void Frame::renderFrame()
   m_renderer->populateFrameData(hd);
 
   hd.camera = (CameraGPUData *)m_camera->deviceData();
+  hd.cameras = nullptr;
+  if (m_cameras) {
+    m_cameraRecords.resize(m_numLayers);
+    auto **cameras = (Camera **)m_cameras->handles();
+    std::transform(cameras,
+        cameras + m_numLayers,
+        m_cameraRecords.begin(),
+        [&](Camera *c) {
+          if (!c)
+            c = m_camera.ptr;
+          return packCameraRecord(c->cameraData(), c->cameraDataBytes());
+        });
+    m_cameraRecords.upload();
+    hd.cameras = m_cameraRecords.dataDevice();
+  }
+
+  hd.world.features = m_world->sceneFeatures();
+  m_pipelineFeatures = m_renderer->pipelineVariant(hd.world.features);
 
   hd.world.surfaceInstances = m_world->instanceSurfaceGPUData().data();
   hd.world.numSurfaceInstances = m_world->instanceSurfaceGPUData().size();
@@ -239,7 +475,10 @@ void Frame::renderFrame()
 
   hd.registry.samplers = state.registry.samplers.devicePtr();
   hd.registry.geometries = state.registry.geometries.devicePtr();
+  hd.registry.geometryAttributes =
+      state.registry.geometryAttributes.devicePtr();
   hd.registry.materials = state.registry.materials.devicePtr();
+  hd.registry.materialVaryings = state.registry.materialVaryings.devicePtr();
   hd.registry.surfaces = state.registry.surfaces.devicePtr();
   hd.registry.lights = state.registry.lights.devicePtr();
   hd.registry.fields = state.registry.fields.devicePtr();
@@ -250,6 +489,36 @@ void Frame::renderFrame()
   instrument::rangePop(); // frame setup
   instrument::rangePush("render all frames");
 
+  if (m_tiled)
+    renderTiles(spp);
+  else {
+    updateRenderSize();
+    launchSamples(spp);
+
+    if (renderingScaled()) {
+      instrument::rangePush("Frame::upsampleColor()");
+      upsampleColor();
+      instrument::rangePop(); // Frame::upsampleColor()
+    }
+
+    if (m_denoise) {
+      m_denoiseDirty = true;
+      if (m_denoiseInterval > 0 && hd.fb.frameID % m_denoiseInterval == 0)
+        denoise();
+    }
+  }
+
+  instrument::rangePop(); // render all frames
+  cudaEventRecord(m_eventEnd, state.stream);
+  instrument::rangePop(); // Frame::renderFrame()
+  instrument::rangePush("time until FB map");
+}
+
+void Frame::launchSamples(int spp)
+{
+  auto &state = *deviceState();
+  auto &hd = hostData();
+
   for (int i = 0; i < spp; i++) {
     instrument::rangePush("Frame::newFrame()");
     newFrame();
@@ -260,24 +529,72 @@ void Frame::renderFrame()
     instrument::rangePop(); // Frame::upload()
 
     instrument::rangePush("optixLaunch()");
-    OPTIX_CHECK(optixLaunch(m_renderer->pipeline(),
+    OPTIX_CHECK(optixLaunch(m_renderer->pipeline(m_pipelineFeatures),
         state.stream,
         (CUdeviceptr)deviceData(),
         payloadBytes(),
-        m_renderer->sbt(),
+        m_renderer->sbt(m_pipelineFeatures),
         checkerboarding() ? (hd.fb.size.x + 1) / 2 : hd.fb.size.x,
         checkerboarding() ? (hd.fb.size.y + 1) / 2 : hd.fb.size.y,
-        1));
+        m_numLayers));
     instrument::rangePop(); // optixLaunch()
   }
+}
 
-  if (m_denoise)
-    m_denoiser.launch();
+void Frame::renderTiles(int spp)
+{
+  auto &hd = hostData();
 
-  instrument::rangePop(); // render all frames
-  cudaEventRecord(m_eventEnd, state.stream);
-  instrument::rangePop(); // Frame::renderFrame()
-  instrument::rangePush("time until FB map");
+  hd.fb.buffers.outColorVec4 = nullptr;
+  hd.fb.buffers.outColorUint = nullptr;
+  if (hd.fb.format == FrameFormat::FLOAT)
+    hd.fb.buffers.outColorVec4 = (vec4 *)m_pixelBuffer.dataDevice();
+  else
+    hd.fb.buffers.outColorUint = (uint32_t *)m_pixelBuffer.dataDevice();
+
+  const auto numTiles = tileCount(m_frameSize, m_tileSize);
+  for (uint32_t i = 0; i < numTiles; i++) {
+    instrument::rangePush("Frame::renderTile()");
+    const auto tile = frameTile(m_frameSize, m_tileSize, i);
+
+    hd.fb.size = tile.size;
+    hd.fb.invSize = 1.f / vec2(tile.size);
+    hd.fb.imageRegion = tileImageRegion(m_frameSize, tile);
+    hd.fb.seedOffset = i * m_tileSize.x * m_tileSize.y;
+
+    // each tile is rendered from scratch into the same (tile sized) buffers
+    m_nextFrameReset = true;
+    launchSamples(spp);
+
+    const size_t numPixels = size_t(tile.size.x) * tile.size.y;
+    m_pixelBuffer.download(0, numPixels * m_perPixelBytes);
+    const float *depth = nullptr;
+    if (!m_depthBuffer.empty()) {
+      m_depthBuffer.download(0, numPixels);
+      depth = m_depthBuffer.dataHost();
+    }
+
+    if (m_tileCallback) {
+      m_tileCallback(m_tileCallbackUserData,
+          m_pixelBuffer.dataHost(),
+          depth,
+          tile.origin.x,
+          tile.origin.y,
+          tile.size.x,
+          tile.size.y);
+    } else {
+      stitchTile(m_tiledColor.data(),
+          m_frameSize,
+          m_pixelBuffer.dataHost(),
+          tile,
+          m_perPixelBytes);
+      if (depth) {
+        stitchTile(
+            m_tiledDepth.data(), m_frameSize, depth, tile, sizeof(float));
+      }
+    }
+    instrument::rangePop(); // Frame::renderTile()
+  }
 }
 
 bool Frame::ready() const
@@ -295,20 +612,46 @@ void *Frame::map(const char *_channel)
   wait();
 
   std::string_view channel = _channel;
-  if (channel == "color")
-    return mapColorBuffer();
-  else if (channel == "depth")
-    return mapDepthBuffer();
-  else if (channel == "colorGPU")
-    return mapGPUColorBuffer();
-  else if (channel == "depthGPU")
-    return mapGPUDepthBuffer();
-  else if (channel == "normal")
-    return mapNormalBuffer();
-  else if (channel == "albedo")
-    return mapAlbedoBuffer();
-  else
+
+  // "<channel>.<i>" maps layer 'i' of a frame rendering multiple cameras
+  uint32_t layer = 0;
+  if (auto dot = channel.find('.'); dot != std::string_view::npos) {
+    const std::string layerStr(channel.substr(dot + 1));
+    char *end = nullptr;
+    layer = uint32_t(std::strtoul(layerStr.c_str(), &end, 10));
+    if (layerStr.empty() || *end != '\0' || layer >= m_numLayers)
+      return nullptr;
+    channel = channel.substr(0, dot);
+  }
+
+  void *retval = nullptr;
+  size_t bytesPerPixel = 0;
+
+  if (channel == "color") {
+    retval = mapColorBuffer();
+    bytesPerPixel = m_perPixelBytes;
+  } else if (channel == "depth") {
+    retval = mapDepthBuffer();
+    bytesPerPixel = sizeof(float);
+  } else if (channel == "colorGPU") {
+    retval = mapGPUColorBuffer();
+    bytesPerPixel = m_perPixelBytes;
+  } else if (channel == "depthGPU") {
+    retval = mapGPUDepthBuffer();
+    bytesPerPixel = sizeof(float);
+  } else if (channel == "normal") {
+    retval = mapNormalBuffer();
+    bytesPerPixel = sizeof(vec3);
+  } else if (channel == "albedo") {
+    retval = mapAlbedoBuffer();
+    bytesPerPixel = sizeof(vec3);
+  }
+
+  if (!retval)
     return nullptr;
+
+  const size_t layerPixels = size_t(m_frameSize.x) * m_frameSize.y;
+  return (uint8_t *)retval + layer * layerPixels * bytesPerPixel;
 }
 
 void *Frame::mapColorBuffer()
@@ -320,8 +663,13 @@ void *Frame::mapColorBuffer()
 
   instrument::rangePush("copy to host");
 
-  if (m_denoise)
+  if (m_tiled)
+    retval = m_tiledColor.empty() ? nullptr : m_tiledColor.data();
+  else if (m_denoise) {
+    if (m_denoiseInterval == 0 && m_denoiseDirty)
+      denoise();
     retval = m_denoiser.mapColorBuffer();
+  }
   else {
     m_pixelBuffer.download();
     retval = m_pixelBuffer.dataHost();
@@ -346,32 +694,46 @@ void *Frame::mapGPUColorBuffer()
 
   m_frameMappedOnce = true;
 
+  if (m_tiled)
+    return nullptr; // tiles only exist on the host
+
+  if (m_denoise && m_denoiseInterval == 0 && m_denoiseDirty)
+    denoise();
+
   return m_denoise ? m_denoiser.mapGPUColorBuffer()
                    : m_pixelBuffer.dataDevice();
 }
 
 void *Frame::mapDepthBuffer()
 {
-  m_depthBuffer.download();
   m_frameMappedOnce = true;
-  return m_depthBuffer.dataHost();
+  if (m_tiled)
+    return m_tiledDepth.empty() ? nullptr : m_tiledDepth.data();
+  else if (!renderingScaled()) {
+    m_depthBuffer.download();
+    return m_depthBuffer.dataHost();
+  }
+
+  upsampleDepth();
+  m_upsampledDepthBuffer.download();
+  return m_upsampledDepthBuffer.dataHost();
 }
 
 void *Frame::mapGPUDepthBuffer()
 {
   m_frameMappedOnce = true;
-  return m_depthBuffer.dataDevice();
+  if (m_tiled)
+    return nullptr;
+  else if (!renderingScaled())
+    return m_depthBuffer.dataDevice();
+
+  upsampleDepth();
+  return m_upsampledDepthBuffer.dataDevice();
 }
 
 void *Frame::mapAlbedoBuffer()
 {
-  auto &state = *deviceState();
-  const float invFrameID = m_invFrameID;
-  thrust::transform(thrust::cuda::par.on(state.stream),
-      m_accumAlbedo.begin(),
-      m_accumAlbedo.end(),
-      m_deviceAlbedoBuffer.begin(),
-      [=] __device__(const vec3 &in) { return in * invFrameID; });
+  resolveAlbedo();
   m_mappedAlbedoBuffer = m_deviceAlbedoBuffer;
   m_frameMappedOnce = true;
   return m_mappedAlbedoBuffer.data();
@@ -379,13 +741,7 @@ void *Frame::mapAlbedoBuffer()
 
 void *Frame::mapNormalBuffer()
 {
-  auto &state = *deviceState();
-  const float invFrameID = m_invFrameID;
-  thrust::transform(thrust::cuda::par.on(state.stream),
-      m_accumNormal.begin(),
-      m_accumNormal.end(),
-      m_deviceNormalBuffer.begin(),
-      [=] __device__(const vec3 &in) { return in * invFrameID; });
+  resolveNormal();
   m_mappedNormalBuffer = m_deviceNormalBuffer;
   m_frameMappedOnce = true;
   return m_mappedNormalBuffer.data();
@@ -412,6 +768,156 @@ void Frame::checkAccumulationReset()
   }
 }
 
+bool Frame::renderingScaled() const
+{
+  return m_renderSize != m_frameSize;
+}
+
+void Frame::updateRenderSize()
+{
+  auto &hd = hostData();
+
+  const float scale =
+      m_nextFrameReset ? m_renderScaleInteractive : m_renderScale;
+  const uvec2 renderSize = scaledRenderSize(m_frameSize, scale);
+  if (renderSize != m_renderSize) {
+    m_renderSize = renderSize;
+    m_nextFrameReset = true;
+  }
+
+  hd.fb.size = m_renderSize;
+  hd.fb.invSize = 1.f / vec2(m_renderSize);
+  hd.fb.imageRegion = vec4(0.f, 0.f, 1.f, 1.f);
+  hd.fb.seedOffset = 0;
+
+  // when scaled, color is resolved to the output size by upsampleColor()
+  hd.fb.buffers.outColorVec4 = nullptr;
+  hd.fb.buffers.outColorUint = nullptr;
+
+  if (renderingScaled())
+    return;
+  else if (hd.fb.format == FrameFormat::FLOAT)
+    hd.fb.buffers.outColorVec4 = (vec4 *)m_pixelBuffer.dataDevice();
+  else
+    hd.fb.buffers.outColorUint = (uint32_t *)m_pixelBuffer.dataDevice();
+}
+
+void Frame::upsampleColor()
+{
+  auto &hd = hostData();
+
+  UpsampleColorOp op;
+  op.accum = hd.fb.buffers.colorAccumulation;
+  op.depth = hd.fb.buffers.depth;
+  op.normal = hd.fb.buffers.normal;
+  op.srcSize = m_renderSize;
+  op.dstSize = m_frameSize;
+  op.invFrameID = hd.fb.invFrameID;
+  op.format = hd.fb.format;
+  op.filter = m_upsampleFilter;
+  if (op.filter == UpsampleFilter::EDGE_AWARE && (!op.depth || !op.normal))
+    op.filter = UpsampleFilter::BILINEAR;
+  if (hd.fb.format == FrameFormat::FLOAT)
+    op.outColorVec4 = (vec4 *)m_pixelBuffer.dataDevice();
+  else
+    op.outColorUint = (uint32_t *)m_pixelBuffer.dataDevice();
+
+  thrust::for_each(thrust::cuda::par.on(deviceState()->stream),
+      thrust::make_counting_iterator(0u),
+      thrust::make_counting_iterator(m_frameSize.x * m_frameSize.y),
+      op);
+}
+
+void Frame::upsampleDepth()
+{
+  m_upsampledDepthBuffer.resize(m_depthBuffer.size());
+  if (m_depthBuffer.empty())
+    return;
+
+  upsampleBuffer(deviceState()->stream,
+      m_depthBuffer.dataDevice(),
+      m_renderSize,
+      m_upsampledDepthBuffer.dataDevice(),
+      m_frameSize,
+      1.f,
+      true);
+}
+
+void Frame::resolveAlbedo()
+{
+  auto &state = *deviceState();
+  const float invFrameID = m_invFrameID;
+  if (renderingScaled()) {
+    upsampleBuffer(state.stream,
+        thrust::raw_pointer_cast(m_accumAlbedo.data()),
+        m_renderSize,
+        thrust::raw_pointer_cast(m_deviceAlbedoBuffer.data()),
+        m_frameSize,
+        invFrameID,
+        false);
+  } else {
+    thrust::transform(thrust::cuda::par.on(state.stream),
+        m_accumAlbedo.begin(),
+        m_accumAlbedo.end(),
+        m_deviceAlbedoBuffer.begin(),
+        [=] __device__(const vec3 &in) { return in * invFrameID; });
+  }
+}
+
+void Frame::resolveNormal()
+{
+  auto &state = *deviceState();
+  const float invFrameID = m_invFrameID;
+  if (renderingScaled()) {
+    upsampleBuffer(state.stream,
+        thrust::raw_pointer_cast(m_accumNormal.data()),
+        m_renderSize,
+        thrust::raw_pointer_cast(m_deviceNormalBuffer.data()),
+        m_frameSize,
+        invFrameID,
+        false);
+  } else {
+    thrust::transform(thrust::cuda::par.on(state.stream),
+        m_accumNormal.begin(),
+        m_accumNormal.begin() + m_deviceNormalBuffer.size(),
+        m_deviceNormalBuffer.begin(),
+        [=] __device__(const vec3 &in) { return in * invFrameID; });
+  }
+}
+
+void Frame::resolveNormalGuide()
+{
+  // the denoiser expects normals in camera space (x right, y up, z back),
+  // while the normal channel stays in world space
+  const auto &camera = m_camera->cameraData();
+  const vec3 back = -normalize(camera.dir);
+  const vec3 right = normalize(cross(camera.up, back));
+  const vec3 up = cross(back, right);
+
+  auto &state = *deviceState();
+  thrust::transform(thrust::cuda::par.on(state.stream),
+      m_deviceNormalBuffer.begin(),
+      m_deviceNormalBuffer.end(),
+      m_normalGuide.begin(),
+      [=] __device__(const vec3 &n) {
+        return vec3(dot(n, right), dot(n, up), dot(n, back));
+      });
+}
+
+void Frame::denoise()
+{
+  instrument::rangePush("Frame::denoise()");
+  if (!m_deviceAlbedoBuffer.empty())
+    resolveAlbedo();
+  if (!m_normalGuide.empty()) {
+    resolveNormal();
+    resolveNormalGuide();
+  }
+  m_denoiser.launch();
+  m_denoiseDirty = false;
+  instrument::rangePop(); // Frame::denoise()
+}
+
 void Frame::newFrame()
 {
   auto &hd = hostData();
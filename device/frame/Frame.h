@@ -32,19 +32,35 @@
 #pragma once
 
 #include "Denoiser.h"
+#include "array/ObjectArray.h"
+#include "camera/CameraRecord.h"
+#include "FrameConfig.h"
+#include "FrameTiling.h"
 #include "camera/Camera.h"
 #include "gpu/gpu_objects.h"
+#include "gpu/upsample.h"
 #include "renderer/Renderer.h"
 #include "scene/World.h"
 #include "utility/DeviceObject.h"
 // std
 #include <memory>
+#include <vector>
 // thrust
 #include <thrust/device_vector.h>
 #include <thrust/host_vector.h>
 
 namespace visrtx {
 
+// Signature of the function set as the 'tileCallback' frame parameter, which
+// receives each finished tile as a tightly packed image.
+using TileCallback = void (*)(void *userData,
+    const void *color,
+    const float *depth,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height);
+
 struct Frame : public DeviceObject<FrameGPUData>
 {
   static size_t objectCount();
@@ -75,21 +91,51 @@ struct Frame : public DeviceObject<FrameGPUData>
 
  private:
   bool checkerboarding() const;
+  bool renderingScaled() const;
   void checkAccumulationReset();
+  void updateRenderSize();
   void newFrame();
+  void launchSamples(int spp);
+  void renderTiles(int spp);
+  void upsampleColor();
+  void upsampleDepth();
+  void resolveAlbedo();
+  void resolveNormal();
+  void resolveNormalGuide();
+  void denoise();
 
   //// Data ////
 
   float m_invFrameID{1.f};
   int m_perPixelBytes{1};
   bool m_denoise{false};
+  bool m_denoiseDirty{false};
+  int m_denoiseInterval{1};
   bool m_nextFrameReset{true};
   bool m_frameMappedOnce{false}; // NOTE(jda) - for instrumented events
 
+  FrameConfig m_config;
+  int m_bufferReallocations{0};
+  int m_denoiserSetups{0};
+
+  uvec2 m_frameSize{0};
+  uvec2 m_renderSize{0};
+  float m_renderScale{1.f};
+  float m_renderScaleInteractive{1.f};
+  UpsampleFilter m_upsampleFilter{UpsampleFilter::BILINEAR};
+
+  bool m_tiled{false};
+  uvec2 m_tileSize{0};
+  TileCallback m_tileCallback{nullptr};
+  void *m_tileCallbackUserData{nullptr};
+  std::vector<uint8_t> m_tiledColor;
+  std::vector<float> m_tiledDepth;
+
   thrust::device_vector<vec4> m_accumColor;
   HostDeviceArray<uint8_t> m_pixelBuffer;
 
   HostDeviceArray<float> m_depthBuffer;
+  HostDeviceArray<float> m_upsampledDepthBuffer;
 
   thrust::device_vector<vec3> m_accumAlbedo;
   thrust::device_vector<vec3> m_deviceAlbedoBuffer;
@@ -98,10 +144,15 @@ struct Frame : public DeviceObject<FrameGPUData>
   thrust::device_vector<vec3> m_accumNormal;
   thrust::device_vector<vec3> m_deviceNormalBuffer;
   thrust::host_vector<vec3> m_mappedNormalBuffer;
+  thrust::device_vector<vec3> m_normalGuide; // camera space, for the denoiser
 
   anari::IntrusivePtr<Renderer> m_renderer;
   anari::IntrusivePtr<Camera> m_camera;
+  anari::IntrusivePtr<ObjectArray> m_cameras;
+  HostDeviceArray<CameraRecord> m_cameraRecords;
+  uint32_t m_numLayers{1};
   anari::IntrusivePtr<World> m_world;
+  uint32_t m_pipelineFeatures{SCENE_FEATURES_ALL}; // see pipelineVariant()
 
   cudaEvent_t m_eventStart;
   cudaEvent_t m_eventEnd;
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "gpu/gpu_math.h"
+// anari
+#include "anari/anari_enums.h"
+
+namespace visrtx {
+
+// Everything Frame::commit() derives from its parameters that affects which
+// buffers are allocated (and how big they are) or how the denoiser is set up.
+struct FrameConfig
+{
+  uvec2 size{0};
+  uint32_t layers{1}; // one per camera when rendering multiple views
+  ANARIDataType colorType{ANARI_UNKNOWN};
+  bool denoise{false};
+  bool depthBuffer{false};
+  bool albedoChannel{false};
+  bool normalBuffer{false}; // accumulated normals, may exist only as a guide
+  bool normalChannel{false};
+
+  VISRTX_HOST_DEVICE bool floatColor() const
+  {
+    return denoise || colorType == ANARI_FLOAT32_VEC4;
+  }
+};
+
+// Which parts of a Frame need to be (re)allocated when going from one config
+// to another.
+struct FrameConfigDiff
+{
+  bool colorBuffers{false};
+  bool depthBuffer{false};
+  bool albedoBuffers{false};
+  bool normalBuffer{false};
+  bool normalChannelBuffers{false};
+  bool denoiser{false};
+
+  VISRTX_HOST_DEVICE bool any() const
+  {
+    return colorBuffers || depthBuffer || albedoBuffers || normalBuffer
+        || normalChannelBuffers || denoiser;
+  }
+};
+
+VISRTX_HOST_DEVICE FrameConfigDiff diffFrameConfigs(
+    const FrameConfig &prev, const FrameConfig &next)
+{
+  const bool sizeChanged =
+      prev.size != next.size || prev.layers != next.layers;
+
+  FrameConfigDiff diff;
+  diff.colorBuffers = sizeChanged || prev.floatColor() != next.floatColor();
+  diff.depthBuffer = prev.depthBuffer != next.depthBuffer
+      || (next.depthBuffer && sizeChanged);
+  diff.albedoBuffers = prev.albedoChannel != next.albedoChannel
+      || (next.albedoChannel && sizeChanged);
+  diff.normalBuffer = prev.normalBuffer != next.normalBuffer
+      || (next.normalBuffer && sizeChanged);
+  diff.normalChannelBuffers = prev.normalChannel != next.normalChannel
+      || (next.normalChannel && sizeChanged);
+
+  // The denoiser holds on to the pixel and guide buffers, so it must be setup
+  // again if any of them were reallocated or if the output conversion changes.
+  diff.denoiser = prev.denoise != next.denoise
+      || (next.denoise
+          && (diff.colorBuffers || diff.albedoBuffers
+              || diff.normalChannelBuffers
+              || prev.colorType != next.colorType));
+
+  return diff;
+}
+
+} // namespace visrtx
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "gpu/gpu_math.h"
+// std
+#include <cstring>
+
+namespace visrtx {
+
+// A rectangle of pixels of the full frame, in pixel coordinates.
+struct FrameTile
+{
+  uvec2 origin{0};
+  uvec2 size{0};
+};
+
+inline uvec2 tileGridSize(const uvec2 &frameSize, const uvec2 &tileSize)
+{
+  const auto ts = glm::max(tileSize, uvec2(1));
+  return (frameSize + ts - uvec2(1)) / ts;
+}
+
+inline uint32_t tileCount(const uvec2 &frameSize, const uvec2 &tileSize)
+{
+  const auto grid = tileGridSize(frameSize, tileSize);
+  return grid.x * grid.y;
+}
+
+// Tiles are enumerated row-major, tiles on the right/top edges are clipped to
+// the frame.
+inline FrameTile frameTile(
+    const uvec2 &frameSize, const uvec2 &tileSize, uint32_t index)
+{
+  const auto ts = glm::max(tileSize, uvec2(1));
+  const auto grid = tileGridSize(frameSize, ts);
+
+  FrameTile tile;
+  tile.origin = uvec2(index % grid.x, index / grid.x) * ts;
+  tile.size = glm::min(ts, frameSize - tile.origin);
+  return tile;
+}
+
+// Normalized [lower.x, lower.y, upper.x, upper.y] region of the frame covered
+// by a tile, matching the layout of the camera 'imageRegion' parameter.
+inline vec4 tileImageRegion(const uvec2 &frameSize, const FrameTile &tile)
+{
+  const vec2 invSize = 1.f / vec2(frameSize);
+  const vec2 lower = vec2(tile.origin) * invSize;
+  const vec2 upper = vec2(tile.origin + tile.size) * invSize;
+  return vec4(lower, upper);
+}
+
+// Copy a tightly packed tile image into its place in a full frame image.
+inline void stitchTile(void *frame,
+    const uvec2 &frameSize,
+    const void *tileData,
+    const FrameTile &tile,
+    size_t bytesPerPixel)
+{
+  const size_t rowBytes = tile.size.x * bytesPerPixel;
+  auto *dst = (uint8_t *)frame;
+  auto *src = (const uint8_t *)tileData;
+  for (uint32_t y = 0; y < tile.size.y; y++) {
+    const size_t dstPixel =
+        size_t(tile.origin.y + y) * frameSize.x + tile.origin.x;
+    std::memcpy(dst + dstPixel * bytesPerPixel, src + y * rowBytes, rowBytes);
+  }
+}
+
+} // namespace visrtx
@@ -66,9 +66,15 @@ RT_FUNCTION Ray cameraCreateRay(const CameraGPUData *_c, vec2 screen)
 RT_FUNCTION Ray makePrimaryRay(ScreenSample &ss)
 {
   const vec2 r(curand_uniform(&ss.rs) - 0.5f, curand_uniform(&ss.rs) - 0.5f);
-  const auto screen =
-      vec2(ss.pixel.x + r.x, ss.pixel.y + r.y) * ss.frameData->fb.invSize;
-  return cameraCreateRay(ss.frameData->camera, screen);
+  const auto &fb = ss.frameData->fb;
+  auto screen = vec2(ss.pixel.x + r.x, ss.pixel.y + r.y) * fb.invSize;
+  screen = glm::mix(vec2(fb.imageRegion[0], fb.imageRegion[1]),
+      vec2(fb.imageRegion[2], fb.imageRegion[3]),
+      screen);
+  const auto *camera = ss.frameData->cameras
+      ? (const CameraGPUData *)&ss.frameData->cameras[ss.launchIdx.z]
+      : ss.frameData->camera;
+  return cameraCreateRay(camera, screen);
 }
 
 } // namespace visrtx
@@ -56,8 +56,13 @@ RT_FUNCTION ScreenSample createScreenSample(const FrameGPUData &frameData)
   int x = computePixelX(ss.launchIdx.x, frameData.fb.checkerboardID);
   int y = computePixelY(ss.launchIdx.y, frameData.fb.checkerboardID);
   int w = frameData.fb.size.x;
+  int h = frameData.fb.size.y;
+  int layer = ss.launchIdx.z;
   int frameID = frameData.fb.frameID;
-  curand_init(y * w + x, 0, frameID * 512, &ss.rs);
+  curand_init(frameData.fb.seedOffset + (layer * h + y) * w + x,
+      0,
+      frameID * 512,
+      &ss.rs);
 
   ss.pixel.x = x;
   ss.pixel.y = y;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "gpu/gpu_objects.h"
+// std
+#include <cstring>
+#ifdef __CUDACC__
+#include <cuda_fp16.h>
+#endif
+
+namespace visrtx {
+
+VISRTX_HOST_DEVICE float halfToFloat(uint16_t h)
+{
+#ifdef __CUDA_ARCH__
+  return __half2float(__ushort_as_half(h));
+#else
+  const uint32_t sign = uint32_t(h & 0x8000) << 16;
+  uint32_t exponent = (h >> 10) & 0x1F;
+  uint32_t mantissa = h & 0x3FF;
+
+  uint32_t bits = sign;
+  if (exponent == 0x1F) // inf/nan
+    bits |= 0x7F800000 | (mantissa << 13);
+  else if (exponent != 0)
+    bits |= ((exponent + 112) << 23) | (mantissa << 13);
+  else if (mantissa != 0) { // subnormal, renormalize for fp32
+    exponent = 113;
+    while (!(mantissa & 0x400)) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    bits |= (exponent << 23) | ((mantissa & 0x3FF) << 13);
+  }
+
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+#endif
+}
+
+template <typename T>
+VISRTX_HOST_DEVICE const T *typedOffset(const void *mem, uint32_t offset)
+{
+  return ((const T *)mem) + offset;
+}
+
+VISRTX_HOST_DEVICE float decodeAttributeChannel(
+    AttributeFormat format, const void *data, uint32_t i)
+{
+  switch (format) {
+  case AttributeFormat::FLOAT16:
+    return halfToFloat(*typedOffset<uint16_t>(data, i));
+  case AttributeFormat::UFIXED8:
+    return *typedOffset<uint8_t>(data, i) * (1.f / 255.f);
+  case AttributeFormat::UFIXED16:
+    return *typedOffset<uint16_t>(data, i) * (1.f / 65535.f);
+  case AttributeFormat::FLOAT32:
+  default:
+    return *typedOffset<float>(data, i);
+  }
+}
+
+// Attribute element 'offset' widened to a vec4, missing channels are filled
+// in from (0, 0, 0, 1)
+VISRTX_HOST_DEVICE vec4 getAttributeValue(
+    const AttributePtr &ap, uint32_t offset)
+{
+  vec4 retval(0.f, 0.f, 0.f, 1.f);
+
+  if (offset == 0xFFFFFFFF || ap.numChannels < 1 || ap.numChannels > 4)
+    return retval;
+
+  if (ap.format == AttributeFormat::FLOAT32) {
+    switch (ap.numChannels) {
+    case 1:
+      return vec4(*typedOffset<float>(ap.data, offset), 0.f, 0.f, 1.f);
+    case 2:
+      return vec4(*typedOffset<vec2>(ap.data, offset), 0.f, 1.f);
+    case 3:
+      return vec4(*typedOffset<vec3>(ap.data, offset), 1.f);
+    default:
+      return *typedOffset<vec4>(ap.data, offset);
+    }
+  }
+
+  // reduced precision elements are tightly packed channels
+  const uint32_t first = offset * ap.numChannels;
+  for (int c = 0; c < ap.numChannels; c++)
+    retval[c] = decodeAttributeChannel(ap.format, ap.data, first + c);
+
+  return retval;
+}
+
+} // namespace visrtx
@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include "gpu/getAttributeValue.h"
 #include "gpu/gpu_util.h"
 
 namespace visrtx {
@@ -46,106 +47,72 @@ RT_FUNCTION const SamplerGPUData &getSamplerData(
   return frameData.registry.samplers[idx];
 }
 
-template <typename T>
-RT_FUNCTION const T *typedOffset(const void *mem, uint32_t offset)
-{
-  return ((const T *)mem) + offset;
-}
-
-RT_FUNCTION vec4 getAttributeValue(const AttributePtr &ap, uint32_t offset)
-{
-  if (offset == 0xFFFFFFFF)
-    return vec4(0.f, 0.f, 0.f, 1.f);
-
-  switch (ap.numChannels) {
-  case 1:
-    return vec4(*typedOffset<float>(ap.data, offset), 0.f, 0.f, 1.f);
-  case 2:
-    return vec4(*typedOffset<vec2>(ap.data, offset), 0.f, 1.f);
-  case 3:
-    return vec4(*typedOffset<vec3>(ap.data, offset), 1.f);
-  case 4:
-    return *typedOffset<vec4>(ap.data, offset);
-  default:
-    break;
-  }
-
-  return vec4(0.f, 0.f, 0.f, 1.f);
-}
-
-RT_FUNCTION uvec3 decodeTriangleAttributeIndices(
-    const GeometryGPUData &ggd, uint32_t attributeID, const SurfaceHit &hit)
+RT_FUNCTION uvec3 decodeTriangleAttributeIndices(const GeometryGPUData &ggd,
+    const GeometryAttributeGPUData &gad,
+    uint32_t attributeID,
+    const SurfaceHit &hit)
 {
-  if (ggd.tri.vertexAttrIndices[attributeID] != nullptr)
-    return ggd.tri.vertexAttrIndices[attributeID][hit.primID];
-  else if (ggd.tri.indices != nullptr)
-    return ggd.tri.indices[hit.primID];
+  if (gad.vertexAttrIndices[attributeID] != nullptr)
+    return gad.vertexAttrIndices[attributeID][hit.primID];
   else
-    return 3 * hit.primID + uvec3(0, 1, 2);
+    return triangleIndices(ggd, hit.primID);
 }
 
 RT_FUNCTION uvec4 decodeQuadAttributeIndices(
-    const GeometryGPUData &ggd, uint32_t attributeID, uint32_t _primID)
+    const GeometryGPUData &ggd, uint32_t attributeID, uint32_t primID)
 {
-  auto primID = (_primID / 2) * 2;
-  auto i0 = ggd.quad.indices[primID + 0];
-  auto i1 = ggd.quad.indices[primID + 1];
-  return uvec4(i0.x, i0.y, i0.z, i1.y);
+  return quadIndices(ggd, primID / 2);
 }
 
 RT_FUNCTION uvec2 decodeCylinderAttributeIndices(
     const GeometryGPUData &ggd, uint32_t attributeID, const SurfaceHit &hit)
 {
-  if (ggd.tri.indices != nullptr)
-    return ggd.tri.indices[hit.primID];
+  if (ggd.cylinder.indices != nullptr)
+    return ggd.cylinder.indices[hit.primID];
   else
     return 2 * hit.primID + uvec2(0, 1);
 }
 
 RT_FUNCTION vec4 readAttributeValue(uint32_t attributeID, const SurfaceHit &hit)
 {
+  if (!hit.attributes)
+    return vec4(0.f, 0.f, 0.f, 1.f);
+
   const auto &ggd = *hit.geometry;
+  const auto &gad = *hit.attributes;
+  const auto &vap = gad.vertexAttr[attributeID];
 
   // First check per-vertex attributes
-  if (ggd.type == GeometryType::TRIANGLE) {
-    const auto &ap = ggd.tri.vertexAttr[attributeID];
-    if (isPopulated(ap)) {
-      const uvec3 idx = decodeTriangleAttributeIndices(ggd, attributeID, hit);
+  if (isPopulated(vap)) {
+    if (ggd.type == GeometryType::TRIANGLE) {
+      const uvec3 idx =
+          decodeTriangleAttributeIndices(ggd, gad, attributeID, hit);
       const vec3 b = hit.uvw;
-      return b.x * getAttributeValue(ap, idx.x)
-          + b.y * getAttributeValue(ap, idx.y)
-          + b.z * getAttributeValue(ap, idx.z);
-    }
-  } else if (ggd.type == GeometryType::QUAD) {
-    const auto &ap = ggd.quad.vertexAttr[attributeID];
-    if (isPopulated(ap)) {
+      return b.x * getAttributeValue(vap, idx.x)
+          + b.y * getAttributeValue(vap, idx.y)
+          + b.z * getAttributeValue(vap, idx.z);
+    } else if (ggd.type == GeometryType::QUAD) {
       const uvec4 idx =
           decodeQuadAttributeIndices(ggd, attributeID, hit.primID);
       const vec3 b = hit.uvw;
-      auto v0 = getAttributeValue(ap, idx.x);
-      auto v1 = getAttributeValue(ap, idx.y);
-      auto v2 = getAttributeValue(ap, idx.z);
-      auto v3 = getAttributeValue(ap, idx.w);
+      auto v0 = getAttributeValue(vap, idx.x);
+      auto v1 = getAttributeValue(vap, idx.y);
+      auto v2 = getAttributeValue(vap, idx.z);
+      auto v3 = getAttributeValue(vap, idx.w);
       auto l0 = mix(v3, v0, b.z);
       auto l1 = mix(v2, v1, b.z);
       return mix(l0, l1, b.x);
-    }
-  } else if (ggd.type == GeometryType::CYLINDER) {
-    const auto &ap = ggd.cylinder.vertexAttr[attributeID];
-    if (isPopulated(ap)) {
+    } else if (ggd.type == GeometryType::CYLINDER) {
       const uvec2 idx = decodeCylinderAttributeIndices(ggd, attributeID, hit);
       const vec3 b = hit.uvw;
-      return b.y * getAttributeValue(ap, idx.x)
-          + b.z * getAttributeValue(ap, idx.y);
-    }
-  } else if (ggd.type == GeometryType::SPHERE) {
-    const auto &ap = ggd.sphere.vertexAttr[attributeID];
-    if (isPopulated(ap))
-      return getAttributeValue(ap, hit.primID);
+      return b.y * getAttributeValue(vap, idx.x)
+          + b.z * getAttributeValue(vap, idx.y);
+    } else if (ggd.type == GeometryType::SPHERE)
+      return getAttributeValue(vap, hit.primID);
   }
 
   // Else fall through to per-primitive attributes
-  const auto &ap = ggd.attr[attributeID];
+  const auto &ap = gad.attr[attributeID];
   if (ggd.type == GeometryType::QUAD)
     return getAttributeValue(ap, hit.primID / 2);
   else if (ggd.type == GeometryType::CONE)
@@ -183,14 +150,18 @@ RT_FUNCTION T evaluateSampler(
 
 template <typename T>
 RT_FUNCTION T getMaterialParameter(const FrameGPUData &fd,
-    const MaterialParameter<T> &mp,
+    const MaterialGPUData &md,
+    MaterialParameterId id,
+    const T &value,
     const SurfaceHit &hit)
 {
-  switch (mp.type) {
-  case MaterialParameterType::VALUE:
-    return mp.value;
+  if (!isVarying(md, id))
+    return value;
+
+  const auto &mv = fd.registry.materialVaryings[md.varyingData];
+  switch (mv.type[id]) {
   case MaterialParameterType::SAMPLER:
-    return evaluateSampler<T>(fd, mp.sampler, hit);
+    return evaluateSampler<T>(fd, mv.sampler[id], hit);
   case MaterialParameterType::ATTRIB_0:
     return bit_cast<T>(readAttributeValue(0, hit));
   case MaterialParameterType::ATTRIB_1:
@@ -219,16 +190,42 @@ RT_FUNCTION T getMaterialParameter(const FrameGPUData &fd,
   return T{};
 }
 
+RT_FUNCTION vec3 getMaterialBaseColor(
+    const FrameGPUData &fd, const MaterialGPUData &md, const SurfaceHit &hit)
+{
+  return getMaterialParameter(
+      fd, md, MATERIAL_PARAMETER_BASE_COLOR, md.values.baseColor, hit);
+}
+
+RT_FUNCTION float getMaterialOpacity(
+    const FrameGPUData &fd, const MaterialGPUData &md, const SurfaceHit &hit)
+{
+  return getMaterialParameter(
+      fd, md, MATERIAL_PARAMETER_OPACITY, md.values.opacity, hit);
+}
+
 RT_FUNCTION MaterialValues getMaterialValues(
     const FrameGPUData &fd, const MaterialGPUData &md, const SurfaceHit &hit)
 {
+  // fully constant materials skip reading their varying parameters entirely
+  if (md.varying == 0)
+    return md.values;
+
+  const auto &v = md.values;
   MaterialValues retval;
-  retval.baseColor = getMaterialParameter(fd, md.baseColor, hit);
-  retval.metalness = getMaterialParameter(fd, md.metalness, hit);
-  retval.emissive = getMaterialParameter(fd, md.emissive, hit);
-  retval.roughness = getMaterialParameter(fd, md.roughness, hit);
-  retval.transmissiveness = getMaterialParameter(fd, md.transmissiveness, hit);
-  retval.opacity = getMaterialParameter(fd, md.opacity, hit);
+  retval.baseColor = getMaterialBaseColor(fd, md, hit);
+  retval.metalness = getMaterialParameter(
+      fd, md, MATERIAL_PARAMETER_METALNESS, v.metalness, hit);
+  retval.emissive = getMaterialParameter(
+      fd, md, MATERIAL_PARAMETER_EMISSIVE, v.emissive, hit);
+  retval.roughness = getMaterialParameter(
+      fd, md, MATERIAL_PARAMETER_ROUGHNESS, v.roughness, hit);
+  retval.transmissiveness = getMaterialParameter(fd,
+      md,
+      MATERIAL_PARAMETER_TRANSMISSIVENESS,
+      v.transmissiveness,
+      hit);
+  retval.opacity = getMaterialOpacity(fd, md, hit);
   return retval;
 }
 
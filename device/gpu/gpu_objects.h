@@ -84,9 +84,19 @@ struct OrthographicCameraGPUData : public CameraGPUData
   vec3 pos_00;
 };
 
+// Fixed size storage for any camera subtype, so an array of cameras can be
+// indexed with a uniform stride on the device.
+struct CameraRecord
+{
+  alignas(16) uint8_t bytes[sizeof(PerspectiveCameraGPUData)
+              > sizeof(OrthographicCameraGPUData)
+          ? sizeof(PerspectiveCameraGPUData)
+          : sizeof(OrthographicCameraGPUData)];
+};
+
 // Geometry //
 
-enum GeometryType
+enum GeometryType : uint8_t
 {
   TRIANGLE,
   QUAD,
@@ -96,41 +106,48 @@ enum GeometryType
   UNKNOWN
 };
 
+enum class AttributeFormat
+{
+  FLOAT32,
+  FLOAT16,
+  UFIXED8, // normalized to [0, 1]
+  UFIXED16 // normalized to [0, 1]
+};
+
 struct AttributePtr
 {
   int numChannels;
+  AttributeFormat format;
   void *data;
 };
 
+// Geometry records are split by access frequency: GeometryGPUData holds what
+// intersection and normal computation read on every hit and stays small,
+// while attribute arrays (only read by materials which use them) live in a
+// GeometryAttributeGPUData side table referenced by index.
+
 struct TriangleGeometryData
 {
-  const uvec3 *indices;
-
+  const void *indices; // uvec3 or u16vec3, null if not indexed
   const vec3 *vertices;
-  AttributePtr vertexAttr[5]; // attribute0-3 + color
   const vec3 *vertexNormals;
-
   const uvec3 *vertexNormalIndices;
-  const uvec3 *vertexAttrIndices[5];
 };
 
+// Quads are kept in their native layout, each quad (a, b, c, d) is split into
+// the triangles (a, b, c) and (c, d, a) which are primitives 2q and 2q + 1
 struct QuadGeometryData
 {
-  const uvec3 *indices;
-
+  const void *indices; // uvec4 or u16vec4, null if not indexed
   const vec3 *vertices;
-  AttributePtr vertexAttr[5]; // attribute0-3 + color
   const vec3 *vertexNormals;
-
   const uvec3 *vertexNormalIndices;
-  const uvec3 *vertexAttrIndices[5];
 };
 
 struct CylinderGeometryData
 {
   const uvec2 *indices;
   const vec3 *vertices;
-  AttributePtr vertexAttr[5]; // attribute0-3 + color
   float *radii;
   float radius;
   bool caps;
@@ -140,14 +157,12 @@ struct ConeGeometryData
 {
   const uvec3 *indices; // actually triangles
   const vec3 *vertices;
-  AttributePtr vertexAttr[5]; // attribute0-3 + color
   uint8_t trianglesPerCone;
 };
 
 struct SphereGeometryData
 {
   vec3 *centers;
-  AttributePtr vertexAttr[5]; // attribute0-3 + color
   float *radii;
   float radius;
 };
@@ -155,8 +170,9 @@ struct SphereGeometryData
 struct GeometryGPUData
 {
   GeometryType type{GeometryType::UNKNOWN};
-  AttributePtr attr[5]; // attribute0-3 + color
-  const uint32 *primID{nullptr};
+  bool shortIndices{false}; // 16-bit triangle or quad indices
+  // index into ObjectRegistry::geometryAttributes, -1 without any attributes
+  DeviceObjectIndex attributes{-1};
   union
   {
     TriangleGeometryData tri{};
@@ -167,6 +183,55 @@ struct GeometryGPUData
   };
 };
 
+struct GeometryAttributeGPUData
+{
+  AttributePtr attr[5]; // per-primitive attribute0-3 + color
+  AttributePtr vertexAttr[5]; // per-vertex attribute0-3 + color
+  const uvec3 *vertexAttrIndices[5]; // triangles and quads only
+  const uint32 *primID{nullptr};
+};
+
+static_assert(sizeof(GeometryGPUData) <= 40,
+    "GeometryGPUData is read on every hit, keep it small");
+
+VISRTX_HOST_DEVICE uvec3 triangleIndices(
+    const GeometryGPUData &gd, uint32_t primID)
+{
+  if (!gd.tri.indices)
+    return uvec3(3 * primID) + uvec3(0, 1, 2);
+  else if (gd.shortIndices)
+    return uvec3(((const u16vec3 *)gd.tri.indices)[primID]);
+  else
+    return ((const uvec3 *)gd.tri.indices)[primID];
+}
+
+VISRTX_HOST_DEVICE uvec4 quadIndices(const GeometryGPUData &gd, uint32_t quadID)
+{
+  if (!gd.quad.indices)
+    return uvec4(4 * quadID) + uvec4(0, 1, 2, 3);
+  else if (gd.shortIndices)
+    return uvec4(((const u16vec4 *)gd.quad.indices)[quadID]);
+  else
+    return ((const uvec4 *)gd.quad.indices)[quadID];
+}
+
+// Vertex indices of triangle 'primID' of a quad geometry
+VISRTX_HOST_DEVICE uvec3 quadTriangleIndices(
+    const GeometryGPUData &gd, uint32_t primID)
+{
+  const uvec4 q = quadIndices(gd, primID / 2);
+  return (primID & 1) ? uvec3(q.z, q.w, q.x) : uvec3(q.x, q.y, q.z);
+}
+
+VISRTX_HOST_DEVICE bool hasAttributes(const GeometryAttributeGPUData &ad)
+{
+  for (int i = 0; i < 5; i++) {
+    if (ad.attr[i].data || ad.vertexAttr[i].data || ad.vertexAttrIndices[i])
+      return true;
+  }
+  return ad.primID != nullptr;
+}
+
 // Samplers //
 
 enum class SamplerType
@@ -223,6 +288,7 @@ enum class MaterialParameterType
   UNKNOWN
 };
 
+// Host-side description of a material parameter, see packMaterialParameter()
 template <typename T>
 struct MaterialParameter
 {
@@ -241,7 +307,7 @@ struct MaterialParameter
   }
 };
 
-struct MaterialGPUData
+struct MaterialParameters
 {
   MaterialParameter<vec3> baseColor{vec3(1.f)};
   MaterialParameter<float> metalness{1.f};
@@ -261,6 +327,89 @@ struct MaterialValues
   float opacity;
 };
 
+enum MaterialParameterId
+{
+  MATERIAL_PARAMETER_BASE_COLOR = 0,
+  MATERIAL_PARAMETER_METALNESS,
+  MATERIAL_PARAMETER_EMISSIVE,
+  MATERIAL_PARAMETER_ROUGHNESS,
+  MATERIAL_PARAMETER_TRANSMISSIVENESS,
+  MATERIAL_PARAMETER_OPACITY,
+  MATERIAL_PARAMETER_COUNT
+};
+
+// Material records are split like geometry records: constant parameter values
+// are stored inline, parameters which vary over a surface (sampled or read
+// from attributes) are flagged in 'varying' and described by an entry of the
+// MaterialVaryingGPUData side table. Fully constant materials never touch it.
+struct MaterialGPUData
+{
+  MaterialValues values{vec3(1.f), 1.f, vec3(0.f), 1.f, 0.f, 1.f};
+  uint32_t varying{0}; // bit per MaterialParameterId
+  // index into ObjectRegistry::materialVaryings, -1 if 'varying' is empty
+  DeviceObjectIndex varyingData{-1};
+};
+
+struct MaterialVaryingGPUData
+{
+  MaterialParameterType type[MATERIAL_PARAMETER_COUNT];
+  DeviceObjectIndex sampler[MATERIAL_PARAMETER_COUNT];
+};
+
+static_assert(sizeof(MaterialGPUData) <= 48,
+    "MaterialGPUData is read on every hit, keep it small");
+static_assert(sizeof(MaterialVaryingGPUData) <= 48,
+    "MaterialVaryingGPUData should fit a single cache line");
+
+VISRTX_HOST_DEVICE bool isVarying(
+    const MaterialGPUData &md, MaterialParameterId id)
+{
+  return (md.varying & (1u << id)) != 0;
+}
+
+template <typename T>
+VISRTX_HOST_DEVICE void packMaterialParameter(MaterialGPUData &md,
+    MaterialVaryingGPUData &mv,
+    MaterialParameterId id,
+    const MaterialParameter<T> &mp,
+    T &value)
+{
+  if (mp.type == MaterialParameterType::VALUE) {
+    value = mp.value;
+    md.varying &= ~(1u << id);
+  } else {
+    md.varying |= 1u << id;
+    mv.type[id] = mp.type;
+    const bool sampled = mp.type == MaterialParameterType::SAMPLER;
+    mv.sampler[id] = sampled ? mp.sampler : -1;
+  }
+}
+
+// Pack 'p' into a hot record and its side table entry; the caller sets
+// md.varyingData if any parameter is varying
+VISRTX_HOST_DEVICE void packMaterialParameters(const MaterialParameters &p,
+    MaterialGPUData &md,
+    MaterialVaryingGPUData &mv)
+{
+  md = MaterialGPUData{};
+  mv = MaterialVaryingGPUData{};
+  packMaterialParameter(
+      md, mv, MATERIAL_PARAMETER_BASE_COLOR, p.baseColor, md.values.baseColor);
+  packMaterialParameter(
+      md, mv, MATERIAL_PARAMETER_METALNESS, p.metalness, md.values.metalness);
+  packMaterialParameter(
+      md, mv, MATERIAL_PARAMETER_EMISSIVE, p.emissive, md.values.emissive);
+  packMaterialParameter(
+      md, mv, MATERIAL_PARAMETER_ROUGHNESS, p.roughness, md.values.roughness);
+  packMaterialParameter(md,
+      mv,
+      MATERIAL_PARAMETER_TRANSMISSIVENESS,
+      p.transmissiveness,
+      md.values.transmissiveness);
+  packMaterialParameter(
+      md, mv, MATERIAL_PARAMETER_OPACITY, p.opacity, md.values.opacity);
+}
+
 // Surface //
 
 struct SurfaceGPUData
@@ -364,9 +513,43 @@ struct LightGPUData
 
 struct InstanceSurfaceGPUData
 {
-  const DeviceObjectIndex *surfaces;
+  const DeviceObjectIndex *surfaces; // per slot
+  // Small surfaces merged into shared build inputs (see TriangleMergePlan):
+  // build input i holds slots [inputSlots[i], inputSlots[i + 1]), slot s
+  // starting at primitive slotPrims[s]. If null, build input i is slot i.
+  const uint32_t *inputSlots;
+  const uint32_t *slotPrims;
+  // Chunk of a split mesh (see MeshSplit): the geometry's primitive index of
+  // each primitive of the chunk's GAS. Null if the GAS isn't a chunk.
+  const uint32_t *primIDs;
 };
 
+struct SurfaceSlot
+{
+  uint32_t slot;
+  uint32_t primID; // within the slot's geometry
+};
+
+VISRTX_HOST_DEVICE SurfaceSlot findSurfaceSlot(
+    const InstanceSurfaceGPUData &inst, uint32_t input, uint32_t primID)
+{
+  if (!inst.inputSlots)
+    return {input, inst.primIDs ? inst.primIDs[primID] : primID};
+
+  // last slot of the build input starting at or before primID
+  uint32_t lo = inst.inputSlots[input];
+  uint32_t hi = inst.inputSlots[input + 1];
+  while (hi - lo > 1) {
+    const uint32_t mid = (lo + hi) / 2;
+    if (inst.slotPrims[mid] <= primID)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  return {lo, primID - inst.slotPrims[lo]};
+}
+
 struct InstanceVolumeGPUData
 {
   const DeviceObjectIndex *volumes;
@@ -380,8 +563,40 @@ struct InstanceLightGPUData
 
 // World //
 
+// Which optional features a world uses, derived on the host when the world's
+// BVHs are built. Renderer pipelines are specialized on these bits, so code
+// paths for absent features are compiled out (see deriveSceneFeatures()).
+enum SceneFeatureFlags : uint32_t
+{
+  SCENE_FEATURE_VOLUMES = 1u << 0,
+  SCENE_FEATURE_NON_OPAQUE = 1u << 1,
+  SCENE_FEATURE_USER_GEOMETRY = 1u << 2,
+  SCENE_FEATURE_LIGHTS_ONE = 1u << 3,
+  SCENE_FEATURE_LIGHTS_MANY = 1u << 4,
+  SCENE_FEATURE_LIGHTS = SCENE_FEATURE_LIGHTS_ONE | SCENE_FEATURE_LIGHTS_MANY,
+  // world traversables are the GASes of a single identity instance (no IAS)
+  SCENE_FEATURE_SINGLE_GAS = 1u << 5,
+  // groups contain instances, i.e. IASes are nested below the world's TLAS
+  SCENE_FEATURE_NESTED_INSTANCING = 1u << 6,
+  // unspecialized: every code path is present and checked at runtime
+  SCENE_FEATURES_ALL = SCENE_FEATURE_VOLUMES | SCENE_FEATURE_NON_OPAQUE
+      | SCENE_FEATURE_USER_GEOMETRY | SCENE_FEATURE_LIGHTS_MANY,
+  // how the world is traversed, which changes the pipeline compile options
+  SCENE_FEATURES_TRAVERSAL =
+      SCENE_FEATURE_SINGLE_GAS | SCENE_FEATURE_NESTED_INSTANCING
+};
+
+// The unspecialized variant able to render a world with the given features:
+// every code path is present, only the traversal structure is kept
+VISRTX_HOST_DEVICE uint32_t genericSceneFeatures(uint32_t features)
+{
+  return SCENE_FEATURES_ALL | (features & SCENE_FEATURES_TRAVERSAL);
+}
+
 struct WorldGPUData
 {
+  uint32_t features;
+
   const InstanceSurfaceGPUData *surfaceInstances;
   size_t numSurfaceInstances;
   OptixTraversableHandle surfacesTraversable;
@@ -432,6 +647,7 @@ struct RendererGPUData
 {
   RendererParametersGPUData params;
   glm::vec4 bgColor;
+  uint32_t visibilityMask; // ray mask tested against instance masks
 };
 
 // Frame //
@@ -463,6 +679,8 @@ struct FramebufferGPUData
   FrameFormat format;
   glm::uvec2 size;
   glm::vec2 invSize;
+  glm::vec4 imageRegion; // sub-region of the camera image being rendered
+  uint32_t seedOffset;
 };
 
 struct FrameGPUData
@@ -471,6 +689,7 @@ struct FrameGPUData
   RendererGPUData renderer;
   WorldGPUData world;
   CameraGPUData *camera;
+  const CameraRecord *cameras; // if set, one camera per launch layer
 
   // Objects //
 
@@ -478,7 +697,9 @@ struct FrameGPUData
   {
     const SamplerGPUData *samplers;
     const GeometryGPUData *geometries;
+    const GeometryAttributeGPUData *geometryAttributes;
     const MaterialGPUData *materials;
+    const MaterialVaryingGPUData *materialVaryings;
     const SurfaceGPUData *surfaces;
     const LightGPUData *lights;
     const SpatialFieldGPUData *fields;
@@ -514,8 +735,10 @@ struct SurfaceHit
   vec3 Ns;
   vec3 uvw;
   uint32_t primID;
+  uint32_t objID; // surface slot within its GAS
   float epsilon;
   const GeometryGPUData *geometry{nullptr};
+  const GeometryAttributeGPUData *attributes{nullptr}; // null if none
   const MaterialGPUData *material{nullptr};
 };
 
@@ -159,6 +159,13 @@ RT_FUNCTION bool pixelOutOfFrame(
   return pixel.x >= fb.size.x || pixel.y >= fb.size.y;
 }
 
+// Constant in pipelines specialized on the scene features, so branches on it
+// are compiled out
+RT_FUNCTION bool sceneHasFeature(const FrameGPUData &fd, uint32_t feature)
+{
+  return (fd.world.features & feature) != 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Outputs ////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -191,6 +198,9 @@ RT_FUNCTION void accumDepth(float *arr, size_t idx, size_t fid, const float &v)
 RT_FUNCTION void writeOutputColor(
     const FramebufferGPUData &fb, const vec4 &color, uint32_t idx)
 {
+  if (!fb.buffers.outColorUint && !fb.buffers.outColorVec4)
+    return; // resolved after the launch (scaled rendering)
+
   const auto c = color * fb.invFrameID;
   if (fb.format == FrameFormat::SRGB)
     fb.buffers.outColorUint[idx] = cvt_uint32(glm::convertLinearToSRGB(c));
@@ -203,7 +213,8 @@ RT_FUNCTION void writeOutputColor(
 RT_FUNCTION uint32_t pixelIndex(
     const FramebufferGPUData &fb, const uvec2 &pixel)
 {
-  return pixel.x + pixel.y * fb.size.x;
+  const uint32_t layer = optixGetLaunchIndex().z;
+  return (layer * fb.size.y + pixel.y) * fb.size.x + pixel.x;
 }
 
 } // namespace detail
@@ -62,7 +62,7 @@ RT_FUNCTION void launchRay(ScreenSample &ss,
       r.t.lower,
       r.t.upper,
       0.0f,
-      OptixVisibilityMask(255),
+      OptixVisibilityMask(ss.frameData->renderer.visibilityMask),
       optixFlags,
       static_cast<uint32_t>(rayType),
       0u,
@@ -96,4 +96,15 @@ RT_FUNCTION void intersectVolume(ScreenSample &ss,
   detail::launchRay(ss, r, rayType, false, dataPtr, optixFlags);
 }
 
+// Occlusion rays terminate on the first accepted hit and the closest hit
+// program reports the occlusion. Any-hit material evaluation (which ignores
+// transparent hits) only runs on surfaces not flagged as opaque, and not at
+// all when the scene has no non-opaque surfaces.
+RT_FUNCTION uint32_t occlusionRayFlags(const FrameGPUData &fd)
+{
+  return sceneHasFeature(fd, SCENE_FEATURE_NON_OPAQUE)
+      ? OPTIX_RAY_FLAG_TERMINATE_ON_FIRST_HIT
+      : OPTIX_RAY_FLAG_DISABLE_ANYHIT | OPTIX_RAY_FLAG_TERMINATE_ON_FIRST_HIT;
+}
+
 } // namespace visrtx
@@ -128,9 +128,46 @@ RT_FUNCTION uint32_t objID()
   return optixGetSbtGASIndex();
 }
 
-RT_FUNCTION uint32_t instID()
+RT_FUNCTION uint32_t instID(const FrameGPUData &frameData)
 {
-  return optixGetInstanceIndex();
+  // a world traced as a single GAS has only the instance data at index 0
+  if (sceneHasFeature(frameData, SCENE_FEATURE_SINGLE_GAS))
+    return 0;
+
+  if (!sceneHasFeature(frameData, SCENE_FEATURE_NESTED_INSTANCING))
+    return optixGetInstanceId();
+
+  // nested instance IDs are offsets relative to the enclosing IAS's instance
+  // data, so the index of the hit GAS's data is their sum
+  uint32_t id = 0;
+  const uint32_t numTransforms = optixGetTransformListSize();
+  for (uint32_t i = 0; i < numTransforms; i++) {
+    id += optixGetInstanceIdFromHandle(optixGetTransformListHandle(i));
+  }
+  return id;
+}
+
+// Identifies the placement of the hit object in the world, i.e. each
+// ANARIInstance (and each transform of a transform array) separately. Unlike
+// instID(), which is shared by all placements of a group, this is only for
+// visualization and never indexes any data.
+RT_FUNCTION uint32_t placementID(const FrameGPUData &frameData)
+{
+  if (sceneHasFeature(frameData, SCENE_FEATURE_SINGLE_GAS))
+    return 0;
+
+  if (!sceneHasFeature(frameData, SCENE_FEATURE_NESTED_INSTANCING))
+    return optixGetInstanceIndex();
+
+  // instance handles refer to distinct OptixInstances per placement, so the
+  // path of handles from the world's TLAS down identifies the placement
+  uint32_t id = optixGetInstanceIndex();
+  const uint32_t numTransforms = optixGetTransformListSize();
+  for (uint32_t i = 0; i < numTransforms; i++) {
+    const auto h = uint64_t(optixGetTransformListHandle(i));
+    id = id * 16777619u ^ uint32_t(h ^ (h >> 32));
+  }
+  return id;
 }
 
 RT_FUNCTION ScreenSample &screenSample()
@@ -154,16 +191,23 @@ RT_FUNCTION bool isIntersectingVolumes()
   return !isIntersectingSurfaces();
 }
 
+// Surface slot and primitive within the surface's geometry of the hit, which
+// differ from the hit build input and primitive for merged surfaces
+RT_FUNCTION SurfaceSlot surfaceSlot(const InstanceSurfaceGPUData &inst)
+{
+  return findSurfaceSlot(inst, ray::objID(), ray::primID());
+}
+
 RT_FUNCTION const SurfaceGPUData &surfaceData(const FrameGPUData &frameData)
 {
-  auto &inst = frameData.world.surfaceInstances[ray::instID()];
-  auto idx = inst.surfaces[ray::objID()];
+  auto &inst = frameData.world.surfaceInstances[ray::instID(frameData)];
+  auto idx = inst.surfaces[ray::surfaceSlot(inst).slot];
   return frameData.registry.surfaces[idx];
 }
 
 RT_FUNCTION const VolumeGPUData &volumeData(const FrameGPUData &frameData)
 {
-  auto &inst = frameData.world.volumeInstances[ray::instID()];
+  auto &inst = frameData.world.volumeInstances[ray::instID(frameData)];
   auto idx = inst.volumes[ray::objID()];
   return frameData.registry.volumes[idx];
 }
@@ -175,9 +219,7 @@ RT_FUNCTION void computeNormal(
 
   switch (ggd.type) {
   case GeometryType::TRIANGLE: {
-    const auto *indices = ggd.tri.indices;
-    const uvec3 idx =
-        indices ? ggd.tri.indices[primID] : uvec3(0, 1, 2) + primID * 3;
+    const uvec3 idx = triangleIndices(ggd, primID);
 
     const vec3 v0 = ggd.tri.vertices[idx.x];
     const vec3 v1 = ggd.tri.vertices[idx.y];
@@ -199,9 +241,7 @@ RT_FUNCTION void computeNormal(
     break;
   }
   case GeometryType::QUAD: {
-    const auto *indices = ggd.quad.indices;
-    const uvec3 idx =
-        indices ? ggd.quad.indices[primID] : uvec3(0, 1, 2) + primID * 3;
+    const uvec3 idx = quadTriangleIndices(ggd, primID);
     const vec3 v0 = ggd.quad.vertices[idx.x];
     const vec3 v1 = ggd.quad.vertices[idx.y];
     const vec3 v2 = ggd.quad.vertices[idx.z];
@@ -250,20 +290,26 @@ RT_FUNCTION void populateSurfaceHit(SurfaceHit &hit)
 {
   auto &ss = ray::screenSample();
   auto &fd = *ss.frameData;
-  auto &sd = ray::surfaceData(fd);
+  auto &inst = fd.world.surfaceInstances[ray::instID(fd)];
+  const auto slot = ray::surfaceSlot(inst);
+  auto &sd = fd.registry.surfaces[inst.surfaces[slot.slot]];
 
   auto &gd = getGeometryData(fd, sd.geometry);
   auto &md = getMaterialData(fd, sd.material);
 
   hit.foundHit = true;
   hit.geometry = &gd;
+  hit.attributes = gd.attributes < 0
+      ? nullptr
+      : &fd.registry.geometryAttributes[gd.attributes];
   hit.material = &md;
   hit.t = ray::t();
   hit.hitpoint = ray::hitpoint();
   hit.uvw = ray::uvw();
-  hit.primID = ray::primID();
+  hit.primID = slot.primID;
+  hit.objID = slot.slot;
   hit.epsilon = epsilonFrom(ray::hitpoint(), ray::direction(), ray::t());
-  ray::computeNormal(gd, ray::primID(), hit);
+  ray::computeNormal(gd, slot.primID, hit);
 }
 
 RT_FUNCTION void populateVolumeHit(VolumeHit &hit)
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "gpu/gpu_math.h"
+
+namespace visrtx {
+
+enum class UpsampleFilter
+{
+  BILINEAR,
+  EDGE_AWARE
+};
+
+VISRTX_HOST_DEVICE uvec2 scaledRenderSize(const uvec2 &size, float scale)
+{
+  scale = glm::clamp(scale, 0.01f, 1.f);
+  const auto scaled = uvec2(glm::ceil(vec2(size) * scale));
+  return glm::max(glm::min(scaled, size), uvec2(1));
+}
+
+VISRTX_HOST_DEVICE vec2 upsampleSourceCoord(
+    const uvec2 &srcSize, const uvec2 &dstSize, const uvec2 &dstPixel)
+{
+  const vec2 s =
+      (vec2(dstPixel) + 0.5f) * (vec2(srcSize) / vec2(dstSize)) - 0.5f;
+  return glm::clamp(s, vec2(0.f), vec2(srcSize - uvec2(1)));
+}
+
+VISRTX_HOST_DEVICE uint32_t upsampleNearestIndex(
+    const uvec2 &srcSize, const uvec2 &dstSize, const uvec2 &dstPixel)
+{
+  const auto p = uvec2(upsampleSourceCoord(srcSize, dstSize, dstPixel) + 0.5f);
+  return p.x + p.y * srcSize.x;
+}
+
+template <typename T>
+VISRTX_HOST_DEVICE T upsampleBilinear(const T *src,
+    const uvec2 &srcSize,
+    const uvec2 &dstSize,
+    const uvec2 &dstPixel)
+{
+  const vec2 s = upsampleSourceCoord(srcSize, dstSize, dstPixel);
+  const uvec2 p0 = uvec2(s);
+  const uvec2 p1 = glm::min(p0 + uvec2(1), srcSize - uvec2(1));
+  const vec2 f = s - vec2(p0);
+
+  const T v00 = src[p0.x + p0.y * srcSize.x];
+  const T v10 = src[p1.x + p0.y * srcSize.x];
+  const T v01 = src[p0.x + p1.y * srcSize.x];
+  const T v11 = src[p1.x + p1.y * srcSize.x];
+
+  return glm::mix(glm::mix(v00, v10, f.x), glm::mix(v01, v11, f.x), f.y);
+}
+
+// Joint bilateral style upsampling: the bilinear taps are re-weighted by how
+// well their depth + normal agree with the source sample nearest to the output
+// pixel, which keeps silhouettes from bleeding into the background. Either
+// guide buffer may be null, in which case it does not contribute.
+VISRTX_HOST_DEVICE vec4 upsampleEdgeAware(const vec4 *color,
+    const float *depth,
+    const vec3 *normal,
+    const uvec2 &srcSize,
+    const uvec2 &dstSize,
+    const uvec2 &dstPixel)
+{
+  const vec2 s = upsampleSourceCoord(srcSize, dstSize, dstPixel);
+  const uvec2 p0 = uvec2(s);
+  const uvec2 p1 = glm::min(p0 + uvec2(1), srcSize - uvec2(1));
+  const vec2 f = s - vec2(p0);
+
+  const uint32_t ref = upsampleNearestIndex(srcSize, dstSize, dstPixel);
+  const float refDepth = depth ? depth[ref] : 0.f;
+  const vec3 refNormal = normal ? normal[ref] : vec3(0.f);
+  const float refNormalLength = glm::length(refNormal);
+
+  const uint32_t taps[4] = {p0.x + p0.y * srcSize.x,
+      p1.x + p0.y * srcSize.x,
+      p0.x + p1.y * srcSize.x,
+      p1.x + p1.y * srcSize.x};
+  const float bilinearWeights[4] = {(1.f - f.x) * (1.f - f.y),
+      f.x * (1.f - f.y),
+      (1.f - f.x) * f.y,
+      f.x * f.y};
+
+  vec4 result(0.f);
+  float weightSum = 0.f;
+
+  for (int i = 0; i < 4; i++) {
+    const uint32_t idx = taps[i];
+    float w = bilinearWeights[i];
+
+    if (depth) {
+      const float d = depth[idx];
+      const float rel =
+          glm::abs(d - refDepth) / glm::max(glm::min(d, refDepth), 1e-6f);
+      w *= 1.f / (1.f + 32.f * rel);
+    }
+
+    if (normal) {
+      const vec3 n = normal[idx];
+      const float nl = glm::length(n);
+      if (nl > 0.f && refNormalLength > 0.f) {
+        const float c =
+            glm::max(glm::dot(n, refNormal) / (nl * refNormalLength), 0.f);
+        const float c2 = c * c;
+        const float c4 = c2 * c2;
+        w *= c4 * c4;
+      }
+    }
+
+    result += w * color[idx];
+    weightSum += w;
+  }
+
+  return weightSum > 1e-6f ? result / weightSum : color[ref];
+}
+
+} // namespace visrtx
@@ -109,6 +109,9 @@ RT_FUNCTION float rayMarchAllVolumes(ScreenSample &ss,
     vec3 &color,
     float &opacity)
 {
+  if (!sceneHasFeature(*ss.frameData, SCENE_FEATURE_VOLUMES))
+    return tfar;
+
   VolumeHit hit;
   ray.t.upper = tfar;
   float depth = tfar;
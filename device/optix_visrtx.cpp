@@ -31,14 +31,181 @@
 
 #include "optix_visrtx.h"
 #include "Object.h"
+// std
+#include <chrono>
 
 namespace visrtx {
 
+// LazyOptixModule definitions ////////////////////////////////////////////////
+
+LazyOptixModule::~LazyOptixModule()
+{
+  destroy();
+}
+
+void LazyOptixModule::setCompileFunction(CompileFcn fcn, ReportFcn report)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_compile = std::move(fcn);
+  m_report = std::move(report);
+}
+
+bool LazyOptixModule::warmUp(uint32_t sceneFeatures)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_compile)
+    return false;
+
+  auto &variant = m_variants[sceneFeatures];
+  if (!variant.result.valid()) {
+    const bool specialized =
+        sceneFeatures != genericSceneFeatures(sceneFeatures);
+    if (specialized && m_numSpecialized >= MAX_SPECIALIZED_VARIANTS) {
+      m_variants.erase(sceneFeatures);
+      return false;
+    }
+    m_numSpecialized += specialized;
+    variant.result =
+        std::async(std::launch::async, m_compile, sceneFeatures).share();
+  }
+  return true;
+}
+
+OptixModule LazyOptixModule::get(uint32_t sceneFeatures)
+{
+  std::shared_future<CompiledOptixModule> result;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_compile)
+      return nullptr;
+    auto v = m_variants.find(sceneFeatures);
+    if (v == m_variants.end() || !v->second.result.valid()) {
+      const uint32_t generic = genericSceneFeatures(sceneFeatures);
+      const bool specialized = sceneFeatures != generic;
+      if (specialized && m_numSpecialized >= MAX_SPECIALIZED_VARIANTS)
+        sceneFeatures = generic; // the generic variant serves every scene
+      else
+        m_numSpecialized += specialized;
+      auto &variant = m_variants[sceneFeatures];
+      if (!variant.result.valid()) {
+        variant.result =
+            std::async(std::launch::deferred, m_compile, sceneFeatures)
+                .share();
+      }
+      result = variant.result;
+    } else
+      result = v->second.result;
+  }
+
+  auto module = result.get().module;
+  reportMessages(sceneFeatures);
+  return module;
+}
+
+bool LazyOptixModule::ready(uint32_t sceneFeatures) const
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto v = m_variants.find(sceneFeatures);
+    if (v == m_variants.end() || !v->second.result.valid()
+        || v->second.result.wait_for(std::chrono::seconds(0))
+            != std::future_status::ready) {
+      return false;
+    }
+  }
+
+  reportMessages(sceneFeatures);
+  return true;
+}
+
+bool LazyOptixModule::used() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return !m_variants.empty();
+}
+
+void LazyOptixModule::destroy()
+{
+  std::map<uint32_t, Variant> variants;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    variants = std::move(m_variants);
+    m_variants.clear();
+    m_numSpecialized = 0;
+  }
+
+  // wait for any in-flight (background) compiles before destroying
+  for (auto &v : variants) {
+    if (!v.second.result.valid())
+      continue;
+    if (auto m = v.second.result.get().module)
+      optixModuleDestroy(m);
+  }
+}
+
+void LazyOptixModule::reportMessages(uint32_t sceneFeatures) const
+{
+  std::shared_future<CompiledOptixModule> result;
+  ReportFcn report;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto v = m_variants.find(sceneFeatures);
+    if (v == m_variants.end() || v->second.reported)
+      return;
+    v->second.reported = true;
+    result = v->second.result; // ready, see callers
+    report = m_report;
+  }
+
+  if (!report)
+    return;
+
+  for (auto &m : result.get().messages)
+    report(m.first, m.second);
+}
+
+// SharedOptixPipeline definitions ////////////////////////////////////////////
+
+SharedOptixPipeline::~SharedOptixPipeline()
+{
+  if (pipeline)
+    optixPipelineDestroy(pipeline);
+  for (auto pg : raygenPGs)
+    optixProgramGroupDestroy(pg);
+  for (auto pg : missPGs)
+    optixProgramGroupDestroy(pg);
+  for (auto pg : hitgroupPGs)
+    optixProgramGroupDestroy(pg);
+}
+
+// Helper functions ///////////////////////////////////////////////////////////
+
+OptixPipelineCompileOptions makePipelineCompileOptions(uint32_t sceneFeatures)
+{
+  OptixPipelineCompileOptions options = {};
+  if (sceneFeatures & SCENE_FEATURE_SINGLE_GAS) {
+    options.traversableGraphFlags =
+        OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_GAS;
+  } else if (sceneFeatures & SCENE_FEATURE_NESTED_INSTANCING) {
+    options.traversableGraphFlags = OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_ANY;
+  } else {
+    options.traversableGraphFlags =
+        OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_LEVEL_INSTANCING;
+  }
+  options.usesMotionBlur = false;
+  options.numPayloadValues = PAYLOAD_VALUES;
+  options.numAttributeValues = ATTRIBUTE_VALUES;
+  options.exceptionFlags = OPTIX_EXCEPTION_FLAG_NONE;
+  options.pipelineLaunchParamsVariableName = "frameData";
+  return options;
+}
+
 void buildOptixBVH(std::vector<OptixBuildInput> buildInput,
     DeviceBuffer &bvh,
     OptixTraversableHandle &traversable,
     box3 &bounds,
-    Object *obj)
+    Object *obj,
+    bool allowUpdate)
 {
   traversable = {};
   bounds = {};
@@ -54,6 +221,8 @@ void buildOptixBVH(std::vector<OptixBuildInput> buildInput,
 
   OptixAccelBuildOptions accelOptions{};
   accelOptions.buildFlags = OPTIX_BUILD_FLAG_ALLOW_COMPACTION;
+  if (allowUpdate)
+    accelOptions.buildFlags |= OPTIX_BUILD_FLAG_ALLOW_UPDATE;
   accelOptions.operation = OPTIX_BUILD_OPERATION_BUILD;
 
   OptixAccelBufferSizes tlasBufferSizes;
@@ -120,6 +289,49 @@ void buildOptixBVH(std::vector<OptixBuildInput> buildInput,
   CUDA_SYNC_CHECK_OBJECT(obj);
 }
 
+void refitOptixBVH(std::vector<OptixBuildInput> buildInput,
+    DeviceBuffer &bvh,
+    OptixTraversableHandle &traversable,
+    Object *obj)
+{
+  if (buildInput.empty() || !traversable)
+    return;
+
+  auto &state = *obj->deviceState();
+
+  // must match the flags of the original build
+  OptixAccelBuildOptions accelOptions{};
+  accelOptions.buildFlags =
+      OPTIX_BUILD_FLAG_ALLOW_COMPACTION | OPTIX_BUILD_FLAG_ALLOW_UPDATE;
+  accelOptions.operation = OPTIX_BUILD_OPERATION_UPDATE;
+
+  OptixAccelBufferSizes bufferSizes;
+  OPTIX_CHECK_OBJECT(optixAccelComputeMemoryUsage(state.optixContext,
+                         &accelOptions,
+                         buildInput.data(),
+                         buildInput.size(),
+                         &bufferSizes),
+      obj);
+
+  DeviceBuffer tempBuffer;
+  tempBuffer.reserve(bufferSizes.tempUpdateSizeInBytes);
+
+  OPTIX_CHECK_OBJECT(optixAccelBuild(state.optixContext,
+                         state.stream,
+                         &accelOptions,
+                         buildInput.data(),
+                         buildInput.size(),
+                         (CUdeviceptr)tempBuffer.ptr(),
+                         tempBuffer.bytes(),
+                         (CUdeviceptr)bvh.ptr(),
+                         bvh.bytes(),
+                         &traversable,
+                         nullptr,
+                         0),
+      obj);
+  CUDA_SYNC_CHECK_OBJECT(obj);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // DeviceGlobalState definitions //////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -136,4 +348,28 @@ void DeviceGlobalState::flushUploadBuffer()
     objectUpdates.lastUploadFlush = newTimeStamp();
 }
 
+void DeviceGlobalState::warmUpModules(uint32_t sceneFeatures)
+{
+  const uint32_t generic = genericSceneFeatures(sceneFeatures);
+
+  // renderer modules are first used when a renderer is created
+  auto &rm = rendererModules;
+  for (auto *m : {&rm.debug,
+           &rm.raycast,
+           &rm.ambientOcclusion,
+           &rm.diffusePathTracer,
+           &rm.scivis}) {
+    if (m->used()) {
+      m->warmUp(generic);
+      m->warmUp(sceneFeatures);
+    }
+  }
+
+  // the generic variant always includes user geometry
+  auto &intersectors = intersectionModules.customIntersectors;
+  intersectors.warmUp(generic);
+  if (sceneFeatures & SCENE_FEATURE_USER_GEOMETRY)
+    intersectors.warmUp(sceneFeatures);
+}
+
 } // namespace visrtx
\ No newline at end of file
@@ -34,14 +34,21 @@
 #include "gpu/gpu_objects.h"
 #include "utility/DeferredCommitBuffer.h"
 #include "utility/DeferredUploadBuffer.h"
+#include "utility/DeviceBuffer.h"
 #include "utility/DeviceObjectArray.h"
+#include "utility/RefCountedCache.h"
 // optix
 #include <optix.h>
 #include <optix_stubs.h>
 // std
 #include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
 #include <vector>
 
 constexpr int PAYLOAD_VALUES = 5;
@@ -101,6 +108,129 @@ namespace visrtx {
 
 using ptx_ptr = unsigned char *;
 
+// Outcome of compiling a module variant. Compiles may run on background
+// threads, so their messages are kept here and only reported by the thread
+// collecting the module (see LazyOptixModule).
+struct CompiledOptixModule
+{
+  OptixModule module{nullptr};
+  std::vector<std::pair<ANARIStatusSeverity, std::string>> messages;
+};
+
+// An OptixModule which is only compiled when first needed, or ahead of time on
+// a background thread by warmUp(). Each set of SceneFeatureFlags is its own
+// variant of the module, compiled and cached independently; the default
+// (SCENE_FEATURES_ALL) is the unspecialized module. All methods are thread
+// safe, compile messages are passed to the report function by the first
+// get() or ready() call which finds the variant compiled.
+struct LazyOptixModule
+{
+  using CompileFcn =
+      std::function<CompiledOptixModule(uint32_t sceneFeatures)>;
+  using ReportFcn =
+      std::function<void(ANARIStatusSeverity, const std::string &)>;
+
+  // Specialized variants warmed up beyond this many are refused, scenes
+  // needing them are rendered with the generic variant instead (see
+  // genericSceneFeatures())
+  static constexpr size_t MAX_SPECIALIZED_VARIANTS = 8;
+
+  LazyOptixModule() = default;
+  ~LazyOptixModule();
+
+  LazyOptixModule(const LazyOptixModule &) = delete;
+  LazyOptixModule &operator=(const LazyOptixModule &) = delete;
+
+  void setCompileFunction(CompileFcn fcn, ReportFcn report);
+
+  // Start compiling asynchronously if not compiling/compiled already, false if
+  // the variant is refused (see MAX_SPECIALIZED_VARIANTS)
+  bool warmUp(uint32_t sceneFeatures = SCENE_FEATURES_ALL);
+  // Get the module, compiling it on the calling thread if not started already.
+  // Specialized variants refused by the cap get the generic variant instead.
+  OptixModule get(uint32_t sceneFeatures = SCENE_FEATURES_ALL);
+
+  bool ready(uint32_t sceneFeatures = SCENE_FEATURES_ALL) const;
+
+  // Whether any variant was ever requested
+  bool used() const;
+
+  // Destroy all variants
+  void destroy();
+
+ private:
+  struct Variant
+  {
+    std::shared_future<CompiledOptixModule> result;
+    mutable bool reported{false};
+  };
+
+  void reportMessages(uint32_t sceneFeatures) const;
+
+  mutable std::mutex m_mutex;
+  CompileFcn m_compile;
+  ReportFcn m_report;
+  std::map<uint32_t, Variant> m_variants;
+  size_t m_numSpecialized{0};
+};
+
+// An OptiX pipeline, its program groups and SBT, which can be shared by all
+// renderers built from the same programs with the same compile options.
+struct SharedOptixPipeline
+{
+  SharedOptixPipeline() = default;
+  ~SharedOptixPipeline();
+
+  SharedOptixPipeline(const SharedOptixPipeline &) = delete;
+  SharedOptixPipeline &operator=(const SharedOptixPipeline &) = delete;
+
+  OptixPipeline pipeline{nullptr};
+
+  std::vector<OptixProgramGroup> raygenPGs;
+  std::vector<OptixProgramGroup> missPGs;
+  std::vector<OptixProgramGroup> hitgroupPGs;
+  DeviceBuffer raygenRecordsBuffer;
+  DeviceBuffer missRecordsBuffer;
+  DeviceBuffer hitgroupRecordsBuffer;
+  OptixShaderBindingTable sbt{};
+};
+
+// What a GAS is built from: the geometry (as of its last commit) and geometry
+// flags of each surface slot, and how slots are merged into build inputs (see
+// TriangleMergePlan). Groups whose surfaces only differ in materials of the
+// same opacity share one GAS, materials being found per instance through
+// InstanceSurfaceGPUData.
+struct BLASKey
+{
+  struct Input
+  {
+    const void *geometry{nullptr};
+    TimeStamp geometryCommitted{0};
+    uint32_t flags{0};
+
+    bool operator<(const Input &o) const
+    {
+      return std::tie(geometry, geometryCommitted, flags)
+          < std::tie(o.geometry, o.geometryCommitted, o.flags);
+    }
+  };
+
+  std::vector<Input> inputs;
+  std::vector<uint32_t> inputSlots;
+
+  bool operator<(const BLASKey &o) const
+  {
+    return std::tie(inputs, inputSlots) < std::tie(o.inputs, o.inputSlots);
+  }
+};
+
+struct CachedBLAS
+{
+  OptixTraversableHandle traversable{};
+  DeviceBuffer bvh;
+  box3 bounds;
+};
+
 struct DeviceGlobalState
 {
   CUcontext cudaContext;
@@ -113,24 +243,33 @@ struct DeviceGlobalState
 
   struct RendererModules
   {
-    OptixModule debug{nullptr};
-    OptixModule raycast{nullptr};
-    OptixModule ambientOcclusion{nullptr};
-    OptixModule diffusePathTracer{nullptr};
-    OptixModule scivis{nullptr};
+    LazyOptixModule debug;
+    LazyOptixModule raycast;
+    LazyOptixModule ambientOcclusion;
+    LazyOptixModule diffusePathTracer;
+    LazyOptixModule scivis;
   } rendererModules;
 
   struct IntersectionModules
   {
-    OptixModule customIntersectors{nullptr};
+    LazyOptixModule customIntersectors;
   } intersectionModules;
 
+  struct PipelineRegistry
+  {
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<SharedOptixPipeline>> pipelines;
+  } pipelineRegistry;
+
+  RefCountedCache<BLASKey, CachedBLAS> blasCache;
+
   struct ObjectUpdates
   {
     TimeStamp lastCommitFlush{0};
     TimeStamp lastUploadFlush{0};
     TimeStamp lastBLASChange{0};
     TimeStamp lastTLASChange{0};
+    TimeStamp lastVisibilityChange{0};
   } objectUpdates;
 
   DeferredCommitBuffer commitBuffer;
@@ -140,7 +279,9 @@ struct DeviceGlobalState
   {
     DeviceObjectArray<SamplerGPUData> samplers;
     DeviceObjectArray<GeometryGPUData> geometries;
+    DeviceObjectArray<GeometryAttributeGPUData> geometryAttributes;
     DeviceObjectArray<MaterialGPUData> materials;
+    DeviceObjectArray<MaterialVaryingGPUData> materialVaryings;
     DeviceObjectArray<SurfaceGPUData> surfaces;
     DeviceObjectArray<LightGPUData> lights;
     DeviceObjectArray<SpatialFieldGPUData> fields;
@@ -151,14 +292,29 @@ struct DeviceGlobalState
 
   void flushCommitBuffer();
   void flushUploadBuffer();
+
+  // Start compiling the module variants for a world with the given features,
+  // for the renderer modules in use
+  void warmUpModules(uint32_t sceneFeatures);
 };
 
 struct Object;
 
+// Compile options every module and pipeline specialized for the given
+// SceneFeatureFlags must agree on
+OptixPipelineCompileOptions makePipelineCompileOptions(uint32_t sceneFeatures);
+
+// 'allowUpdate' BVHs can later be refit in place with refitOptixBVH()
 void buildOptixBVH(std::vector<OptixBuildInput> buildInput,
     DeviceBuffer &bvh,
     OptixTraversableHandle &traversable,
     box3 &bounds,
+    Object *obj,
+    bool allowUpdate = false);
+
+void refitOptixBVH(std::vector<OptixBuildInput> buildInput,
+    DeviceBuffer &bvh,
+    OptixTraversableHandle &traversable,
     Object *obj);
 
 } // namespace visrtx
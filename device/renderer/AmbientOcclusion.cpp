@@ -53,7 +53,7 @@ void AmbientOcclusion::populateFrameData(FrameGPUData &fd) const
   fd.renderer.params.ao.aoSamples = m_aoSamples;
 }
 
-OptixModule AmbientOcclusion::optixModule() const
+LazyOptixModule &AmbientOcclusion::optixModule() const
 {
   return deviceState()->rendererModules.ambientOcclusion;
 }
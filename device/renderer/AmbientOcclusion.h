@@ -40,7 +40,7 @@ struct AmbientOcclusion : public Renderer
   AmbientOcclusion() = default;
   void commit() override;
   void populateFrameData(FrameGPUData &fd) const override;
-  OptixModule optixModule() const override;
+  LazyOptixModule &optixModule() const override;
   anari::Span<const HitgroupFunctionNames> hitgroupSbtNames() const override;
   anari::Span<const std::string> missSbtNames() const override;
 
@@ -46,7 +46,7 @@ DECLARE_FRAME_DATA(frameData)
 RT_FUNCTION bool isOccluded(ScreenSample &ss, Ray r)
 {
   uint32_t o = 0;
-  intersectSurface(ss, r, RayType::AO, &o, OPTIX_RAY_FLAG_DISABLE_CLOSESTHIT);
+  intersectSurface(ss, r, RayType::AO, &o, occlusionRayFlags(frameData));
   return static_cast<bool>(o);
 }
 
@@ -71,7 +71,9 @@ RT_FUNCTION float computeAO(
 
 RT_PROGRAM void __closesthit__ao()
 {
-  // no-op
+  // occlusion rays terminate on the first accepted (i.e. opaque) hit
+  auto &occluded = ray::rayData<uint32_t>();
+  occluded = true;
 }
 
 RT_PROGRAM void __anyhit__ao()
@@ -79,10 +81,8 @@ RT_PROGRAM void __anyhit__ao()
   SurfaceHit hit;
   ray::populateSurfaceHit(hit);
   const auto &material = *hit.material;
-  const auto mat_baseColor =
-      getMaterialParameter(frameData, material.baseColor, hit);
-  const auto mat_opacity =
-      getMaterialParameter(frameData, material.opacity, hit);
+  const auto mat_baseColor = getMaterialBaseColor(frameData, material, hit);
+  const auto mat_opacity = getMaterialOpacity(frameData, material, hit);
   if (mat_opacity >= 0.99f) {
     auto &occluded = ray::rayData<uint32_t>();
     occluded = true;
@@ -143,9 +143,9 @@ RT_PROGRAM void __raygen__()
 
       const auto &material = *surfaceHit.material;
       const auto mat_baseColor =
-          getMaterialParameter(frameData, material.baseColor, surfaceHit);
+          getMaterialBaseColor(frameData, material, surfaceHit);
       const auto mat_opacity =
-          getMaterialParameter(frameData, material.opacity, surfaceHit);
+          getMaterialOpacity(frameData, material, surfaceHit);
 
       const float aoFactor =
           rendererParams.aoSamples > 0 ? computeAO(ss, ray, surfaceHit) : 1.f;
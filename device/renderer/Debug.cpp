@@ -79,7 +79,7 @@ void Debug::populateFrameData(FrameGPUData &fd) const
   fd.renderer.params.debug.method = static_cast<int>(m_method);
 }
 
-OptixModule Debug::optixModule() const
+LazyOptixModule &Debug::optixModule() const
 {
   return deviceState()->rendererModules.debug;
 }
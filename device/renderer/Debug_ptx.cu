@@ -63,17 +63,17 @@ RT_PROGRAM void __closesthit__surface()
   auto method =
       static_cast<Debug::Method>(frameData.renderer.params.debug.method);
 
-  ray::computeNormal(*rd.hit.geometry, ray::primID(), rd.hit);
+  ray::computeNormal(*rd.hit.geometry, rd.hit.primID, rd.hit);
 
   switch (method) {
   case Debug::Method::PRIM_ID:
-    rd.outColor = makeRandomColor(ray::primID());
+    rd.outColor = makeRandomColor(rd.hit.primID);
     break;
   case Debug::Method::GEOM_ID:
-    rd.outColor = makeRandomColor(ray::objID());
+    rd.outColor = makeRandomColor(rd.hit.objID);
     break;
   case Debug::Method::INST_ID:
-    rd.outColor = makeRandomColor(ray::instID());
+    rd.outColor = makeRandomColor(ray::placementID(frameData));
     break;
   case Debug::Method::RAY_UVW:
     rd.outColor = ray::uvw();
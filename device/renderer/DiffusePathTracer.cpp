@@ -50,7 +50,7 @@ void DiffusePathTracer::populateFrameData(FrameGPUData &fd) const
   fd.renderer.params.dpt.R = m_R;
 }
 
-OptixModule DiffusePathTracer::optixModule() const
+LazyOptixModule &DiffusePathTracer::optixModule() const
 {
   return deviceState()->rendererModules.diffusePathTracer;
 }
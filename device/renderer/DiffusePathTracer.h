@@ -40,7 +40,7 @@ struct DiffusePathTracer : public Renderer
   DiffusePathTracer() = default;
   void commit() override;
   void populateFrameData(FrameGPUData &fd) const override;
-  OptixModule optixModule() const override;
+  LazyOptixModule &optixModule() const override;
 
   static ptx_ptr ptx();
 
@@ -114,8 +114,7 @@ RT_PROGRAM void __raygen__()
 
     if (pathData.depth == 0) {
       const auto &material = *hit.material;
-      const auto mat_baseColor =
-          getMaterialParameter(frameData, material.baseColor, hit);
+      const auto mat_baseColor = getMaterialBaseColor(frameData, material, hit);
       outColor = volumeColor;
       accumulateValue(outColor, mat_baseColor, volumeOpacity);
       outOpacity = 1.f;
@@ -35,7 +35,7 @@
 
 namespace visrtx {
 
-OptixModule Raycast::optixModule() const
+LazyOptixModule &Raycast::optixModule() const
 {
   return deviceState()->rendererModules.raycast;
 }
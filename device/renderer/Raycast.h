@@ -38,7 +38,7 @@ namespace visrtx {
 struct Raycast : public Renderer
 {
   Raycast() = default;
-  OptixModule optixModule() const override;
+  LazyOptixModule &optixModule() const override;
 
   static ptx_ptr ptx();
 };
@@ -90,9 +90,9 @@ RT_PROGRAM void __raygen__()
 
       const auto &material = *surfaceHit.material;
       const auto mat_baseColor =
-          getMaterialParameter(frameData, material.baseColor, surfaceHit);
+          getMaterialBaseColor(frameData, material, surfaceHit);
       const auto mat_opacity =
-          getMaterialParameter(frameData, material.opacity, surfaceHit);
+          getMaterialOpacity(frameData, material, surfaceHit);
 
       const auto falloff =
           mat_baseColor * glm::abs(glm::dot(ray.dir, surfaceHit.Ns));
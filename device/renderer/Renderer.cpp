@@ -31,6 +31,7 @@
 
 #include "Renderer.h"
 #include "ParameterInfo.h"
+#include "scene/InstanceLeafTable.h"
 // specific renderers
 #include "AmbientOcclusion.h"
 #include "Debug.h"
@@ -39,7 +40,10 @@
 #include "SciVis.h"
 // std
 #include <stdlib.h>
+#include <sstream>
 #include <string_view>
+// optix
+#include <optix_stack_size.h>
 // this include may only appear in a single source file:
 #include <optix_function_table_definition.h>
 
@@ -54,6 +58,8 @@ using RaygenRecord = SBTRecord;
 using MissRecord = SBTRecord;
 using HitgroupRecord = SBTRecord;
 
+constexpr unsigned int MAX_TRACE_DEPTH = 2;
+
 // Helper functions ///////////////////////////////////////////////////////////
 
 static Renderer *make_renderer(std::string_view subtype)
@@ -127,7 +133,6 @@ Renderer::Renderer()
 
 Renderer::~Renderer()
 {
-  optixPipelineDestroy(m_pipeline);
   s_numRenderers--;
 }
 
@@ -135,6 +140,8 @@ void Renderer::commit()
 {
   m_bgColor = getParam<vec4>("backgroundColor", vec4(1.f));
   m_spp = getParam<int>("pixelSamples", 1);
+  m_visibilityMask = uint8_t(getParam<uint32_t>(
+      "visibilityMask", getParam<uint8_t>("visibilityMask", 0xFF)));
 }
 
 anari::Span<const HitgroupFunctionNames> Renderer::hitgroupSbtNames() const
@@ -150,19 +157,34 @@ anari::Span<const std::string> Renderer::missSbtNames() const
 void Renderer::populateFrameData(FrameGPUData &fd) const
 {
   fd.renderer.bgColor = m_bgColor;
+  fd.renderer.visibilityMask = m_visibilityMask;
 }
 
-OptixPipeline Renderer::pipeline() const
+uint32_t Renderer::pipelineVariant(uint32_t sceneFeatures)
 {
-  return m_pipeline;
+  if (m_pipelines.count(sceneFeatures) != 0)
+    return sceneFeatures;
+
+  auto &module = optixModule();
+  auto &intersectors = deviceState()->intersectionModules.customIntersectors;
+  const bool needsIntersectors = sceneFeatures & SCENE_FEATURE_USER_GEOMETRY;
+
+  const bool specialized = module.warmUp(sceneFeatures)
+      && (!needsIntersectors || intersectors.warmUp(sceneFeatures));
+  const bool ready = specialized && module.ready(sceneFeatures)
+      && (!needsIntersectors || intersectors.ready(sceneFeatures));
+
+  return ready ? sceneFeatures : genericSceneFeatures(sceneFeatures);
 }
 
-const OptixShaderBindingTable *Renderer::sbt()
+OptixPipeline Renderer::pipeline(uint32_t sceneFeatures)
 {
-  if (!m_pipeline)
-    initOptixPipeline();
+  return optixPipeline(sceneFeatures).pipeline;
+}
 
-  return &m_sbt;
+const OptixShaderBindingTable *Renderer::sbt(uint32_t sceneFeatures)
+{
+  return &optixPipeline(sceneFeatures).sbt;
 }
 
 vec4 Renderer::bgColor() const
@@ -188,6 +210,10 @@ Renderer *Renderer::createInstance(
   retval = make_renderer(subtype);
 
   retval->setDeviceState(d);
+
+  // start compiling this renderer's module while the app sets up the scene
+  retval->optixModule().warmUp();
+
   return retval;
 }
 
@@ -199,11 +225,13 @@ const ANARIParameter *Renderer::getParameters(std::string_view subtype)
     static const ANARIParameter raycast[] = {
         {"backgroundColor", ANARI_FLOAT32_VEC4},
         {"pixelSamples", ANARI_INT32},
+        {"visibilityMask", ANARI_UINT32},
         emptyParam};
     return raycast;
   } else if (subtype == "ao") {
     static const ANARIParameter ao[] = {{"backgroundColor", ANARI_FLOAT32_VEC4},
         {"pixelSamples", ANARI_INT32},
+        {"visibilityMask", ANARI_UINT32},
         {"aoSamples", ANARI_INT32},
         emptyParam};
     return ao;
@@ -211,6 +239,7 @@ const ANARIParameter *Renderer::getParameters(std::string_view subtype)
     static const ANARIParameter dpt[] = {
         {"backgroundColor", ANARI_FLOAT32_VEC4},
         {"pixelSamples", ANARI_INT32},
+        {"visibilityMask", ANARI_UINT32},
         {"maxDepth", ANARI_INT32},
         {"R", ANARI_FLOAT32},
         emptyParam};
@@ -219,6 +248,7 @@ const ANARIParameter *Renderer::getParameters(std::string_view subtype)
     static const ANARIParameter scivis[] = {
         {"backgroundColor", ANARI_FLOAT32_VEC4},
         {"pixelSamples", ANARI_INT32},
+        {"visibilityMask", ANARI_UINT32},
         {"lightFalloff", ANARI_FLOAT32},
         {"ambientSamples", ANARI_INT32},
         {"ambientIntensity", ANARI_FLOAT32},
@@ -229,6 +259,7 @@ const ANARIParameter *Renderer::getParameters(std::string_view subtype)
     static const ANARIParameter method[] = {
         {"backgroundColor", ANARI_FLOAT32_VEC4},
         {"pixelSamples", ANARI_INT32},
+        {"visibilityMask", ANARI_UINT32},
         {"method", ANARI_STRING},
         emptyParam};
     return method;
@@ -249,6 +280,13 @@ const void *Renderer::getParameterInfo(std::string_view subtype,
   } else if (paramName == "pixelSamples" && paramType == ANARI_INT32) {
     static const ParameterInfo param(false, "samples per-pixel each frame", 1);
     return param.fromString(infoName, infoType);
+  } else if (paramName == "visibilityMask" && paramType == ANARI_UINT32) {
+    static const ParameterInfo param(false,
+        "ray mask, only instances sharing a bit with it are visible",
+        uint32_t(0xFF),
+        uint32_t(0),
+        uint32_t(0xFF));
+    return param.fromString(infoName, infoType);
   } else {
     if (subtype == "ao") {
       AmbientOcclusion::getParameterInfo(
@@ -266,11 +304,69 @@ const void *Renderer::getParameterInfo(std::string_view subtype,
   return nullptr;
 }
 
-void Renderer::initOptixPipeline()
+std::string Renderer::pipelineKey(uint32_t sceneFeatures) const
+{
+  const auto options = makePipelineCompileOptions(sceneFeatures);
+
+  std::stringstream ss;
+  ss << &optixModule() << ';' << sceneFeatures << ';'
+     << options.traversableGraphFlags << ','
+     << options.usesMotionBlur << ',' << options.numPayloadValues << ','
+     << options.numAttributeValues << ',' << options.exceptionFlags << ','
+     << MAX_TRACE_DEPTH;
+  for (auto &mn : missSbtNames())
+    ss << ";miss:" << mn;
+  for (auto &hgn : hitgroupSbtNames())
+    ss << ";hit:" << hgn.closestHit << ',' << hgn.anyHit;
+  return ss.str();
+}
+
+SharedOptixPipeline &Renderer::optixPipeline(uint32_t sceneFeatures)
+{
+  auto &p = m_pipelines[sceneFeatures];
+  if (!p)
+    p = initOptixPipeline(sceneFeatures);
+  return *p;
+}
+
+std::shared_ptr<SharedOptixPipeline> Renderer::initOptixPipeline(
+    uint32_t sceneFeatures)
+{
+  auto &registry = deviceState()->pipelineRegistry;
+  const auto key = pipelineKey(sceneFeatures);
+
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  auto &entry = registry.pipelines[key];
+  if (auto p = entry.lock()) {
+    reportMessage(ANARI_SEVERITY_DEBUG, "reusing existing OptiX pipeline");
+    return p;
+  }
+
+  // drop entries of pipelines which are no longer used by any renderer
+  for (auto i = registry.pipelines.begin(); i != registry.pipelines.end();) {
+    if (i->first != key && i->second.expired())
+      i = registry.pipelines.erase(i);
+    else
+      ++i;
+  }
+
+  reportMessage(ANARI_SEVERITY_DEBUG,
+      "building OptiX pipeline for scene features 0x%x",
+      sceneFeatures);
+
+  auto p = std::make_shared<SharedOptixPipeline>();
+  buildOptixPipeline(*p, sceneFeatures);
+  entry = p;
+  return p;
+}
+
+void Renderer::buildOptixPipeline(
+    SharedOptixPipeline &p, uint32_t sceneFeatures)
 {
   auto &state = *deviceState();
 
-  auto om = optixModule();
+  auto om = optixModule().get(sceneFeatures);
 
   char log[2048];
   size_t sizeof_log = sizeof(log);
@@ -278,7 +374,7 @@ void Renderer::initOptixPipeline()
   // Raygen program //
 
   {
-    m_raygenPGs.resize(1);
+    p.raygenPGs.resize(1);
 
     OptixProgramGroupOptions pgOptions = {};
     OptixProgramGroupDesc pgDesc = {};
@@ -293,7 +389,7 @@ void Renderer::initOptixPipeline()
         &pgOptions,
         log,
         &sizeof_log,
-        &m_raygenPGs[0]));
+        &p.raygenPGs[0]));
 
     if (sizeof_log > 1)
       reportMessage(ANARI_SEVERITY_DEBUG, "PG Raygen Log:\n%s\n", log);
@@ -304,9 +400,9 @@ void Renderer::initOptixPipeline()
   {
     auto missNames = missSbtNames();
 
-    m_missPGs.resize(missNames.size());
+    p.missPGs.resize(missNames.size());
 
-    for (int i = 0; i < m_missPGs.size(); i++) {
+    for (int i = 0; i < p.missPGs.size(); i++) {
       auto &mn = missNames[i];
 
       OptixProgramGroupOptions pgOptions = {};
@@ -322,7 +418,7 @@ void Renderer::initOptixPipeline()
           &pgOptions,
           log,
           &sizeof_log,
-          &m_missPGs[i]));
+          &p.missPGs[i]));
 
       if (sizeof_log > 1)
         reportMessage(ANARI_SEVERITY_DEBUG, "PG Miss Log:\n%s", log);
@@ -334,9 +430,9 @@ void Renderer::initOptixPipeline()
   {
     auto hitgroupNames = hitgroupSbtNames();
 
-    m_hitgroupPGs.resize(hitgroupNames.size());
+    p.hitgroupPGs.resize(hitgroupNames.size());
 
-    for (int i = 0; i < m_hitgroupPGs.size(); i++) {
+    for (int i = 0; i < p.hitgroupPGs.size(); i++) {
       auto &hgn = hitgroupNames[i];
 
       OptixProgramGroupOptions pgOptions = {};
@@ -351,8 +447,12 @@ void Renderer::initOptixPipeline()
         pgDesc.hitgroup.entryFunctionNameAH = hgn.anyHit.c_str();
       }
 
-      pgDesc.hitgroup.moduleIS = state.intersectionModules.customIntersectors;
-      pgDesc.hitgroup.entryFunctionNameIS = "__intersection__";
+      // without user geometry only built-in triangles are ever hit
+      if (sceneFeatures & SCENE_FEATURE_USER_GEOMETRY) {
+        pgDesc.hitgroup.moduleIS =
+            state.intersectionModules.customIntersectors.get(sceneFeatures);
+        pgDesc.hitgroup.entryFunctionNameIS = "__intersection__";
+      }
 
       sizeof_log = sizeof(log);
       OPTIX_CHECK(optixProgramGroupCreate(state.optixContext,
@@ -361,7 +461,7 @@ void Renderer::initOptixPipeline()
           &pgOptions,
           log,
           &sizeof_log,
-          &m_hitgroupPGs[i]));
+          &p.hitgroupPGs[i]));
 
       if (sizeof_log > 1)
         reportMessage(ANARI_SEVERITY_DEBUG, "PG Hitgroup Log:\n%s", log);
@@ -371,24 +471,17 @@ void Renderer::initOptixPipeline()
   // Pipeline //
 
   {
-    OptixPipelineCompileOptions pipelineCompileOptions = {};
-    pipelineCompileOptions.traversableGraphFlags =
-        OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_LEVEL_INSTANCING;
-    pipelineCompileOptions.usesMotionBlur = false;
-    pipelineCompileOptions.numPayloadValues = PAYLOAD_VALUES;
-    pipelineCompileOptions.numAttributeValues = ATTRIBUTE_VALUES;
-    pipelineCompileOptions.exceptionFlags = OPTIX_EXCEPTION_FLAG_NONE;
-    pipelineCompileOptions.pipelineLaunchParamsVariableName = "frameData";
+    auto pipelineCompileOptions = makePipelineCompileOptions(sceneFeatures);
 
     OptixPipelineLinkOptions pipelineLinkOptions = {};
-    pipelineLinkOptions.maxTraceDepth = 2;
+    pipelineLinkOptions.maxTraceDepth = MAX_TRACE_DEPTH;
 
     std::vector<OptixProgramGroup> programGroups;
-    for (auto pg : m_raygenPGs)
+    for (auto pg : p.raygenPGs)
       programGroups.push_back(pg);
-    for (auto pg : m_missPGs)
+    for (auto pg : p.missPGs)
       programGroups.push_back(pg);
-    for (auto pg : m_hitgroupPGs)
+    for (auto pg : p.hitgroupPGs)
       programGroups.push_back(pg);
 
     sizeof_log = sizeof(log);
@@ -399,45 +492,70 @@ void Renderer::initOptixPipeline()
         programGroups.size(),
         log,
         &sizeof_log,
-        &m_pipeline));
+        &p.pipeline));
 
     if (sizeof_log > 1)
       reportMessage(ANARI_SEVERITY_DEBUG, "Pipeline Create Log:\n%s", log);
+
+    // the default stack size only covers a traversable graph depth of 2
+    if (sceneFeatures & SCENE_FEATURE_NESTED_INSTANCING) {
+      OptixStackSizes stackSizes = {};
+      for (auto pg : programGroups)
+        OPTIX_CHECK(optixUtilAccumulateStackSizes(pg, &stackSizes));
+
+      uint32_t dcStackSizeFromTraversal = 0;
+      uint32_t dcStackSizeFromState = 0;
+      uint32_t continuationStackSize = 0;
+      OPTIX_CHECK(optixUtilComputeStackSizes(&stackSizes,
+          MAX_TRACE_DEPTH,
+          0,
+          0,
+          &dcStackSizeFromTraversal,
+          &dcStackSizeFromState,
+          &continuationStackSize));
+
+      // world TLAS + nested IASes + GAS
+      OPTIX_CHECK(optixPipelineSetStackSize(p.pipeline,
+          dcStackSizeFromTraversal,
+          dcStackSizeFromState,
+          continuationStackSize,
+          MAX_NESTED_INSTANCING_DEPTH + 2));
+    }
   }
 
   // SBT //
 
   {
     std::vector<RaygenRecord> raygenRecords;
-    for (auto &pg : m_raygenPGs) {
+    for (auto &pg : p.raygenPGs) {
       RaygenRecord rec;
       OPTIX_CHECK(optixSbtRecordPackHeader(pg, &rec));
       raygenRecords.push_back(rec);
     }
-    m_raygenRecordsBuffer.upload(raygenRecords);
-    m_sbt.raygenRecord = (CUdeviceptr)m_raygenRecordsBuffer.ptr();
+    p.raygenRecordsBuffer.upload(raygenRecords);
+    p.sbt.raygenRecord = (CUdeviceptr)p.raygenRecordsBuffer.ptr();
 
     std::vector<MissRecord> missRecords;
-    for (auto &pg : m_missPGs) {
+    for (auto &pg : p.missPGs) {
       MissRecord rec;
       OPTIX_CHECK(optixSbtRecordPackHeader(pg, &rec));
       missRecords.push_back(rec);
     }
-    m_missRecordsBuffer.upload(missRecords);
-    m_sbt.missRecordBase = (CUdeviceptr)m_missRecordsBuffer.ptr();
-    m_sbt.missRecordStrideInBytes = sizeof(MissRecord);
-    m_sbt.missRecordCount = missRecords.size();
+    p.missRecordsBuffer.upload(missRecords);
+    p.sbt.missRecordBase = (CUdeviceptr)p.missRecordsBuffer.ptr();
+    p.sbt.missRecordStrideInBytes = sizeof(MissRecord);
+    p.sbt.missRecordCount = missRecords.size();
 
     std::vector<HitgroupRecord> hitgroupRecords;
-    for (auto &hpg : m_hitgroupPGs) {
+    for (auto &hpg : p.hitgroupPGs) {
       HitgroupRecord rec;
       OPTIX_CHECK(optixSbtRecordPackHeader(hpg, &rec));
       hitgroupRecords.push_back(rec);
     }
-    m_hitgroupRecordsBuffer.upload(hitgroupRecords);
-    m_sbt.hitgroupRecordBase = (CUdeviceptr)m_hitgroupRecordsBuffer.ptr();
-    m_sbt.hitgroupRecordStrideInBytes = sizeof(HitgroupRecord);
-    m_sbt.hitgroupRecordCount = hitgroupRecords.size();
+    p.hitgroupRecordsBuffer.upload(hitgroupRecords);
+    p.sbt.hitgroupRecordBase = (CUdeviceptr)p.hitgroupRecordsBuffer.ptr();
+    p.sbt.hitgroupRecordStrideInBytes = sizeof(HitgroupRecord);
+    p.sbt.hitgroupRecordCount = hitgroupRecords.size();
   }
 }
 
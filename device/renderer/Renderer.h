@@ -36,6 +36,9 @@
 // optix
 #include <optix.h>
 // std
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 // anari
 #include "anari/detail/Span.h"
@@ -57,15 +60,23 @@ struct Renderer : public Object
 
   virtual void commit() override;
 
-  virtual OptixModule optixModule() const = 0;
+  virtual LazyOptixModule &optixModule() const = 0;
 
   virtual anari::Span<const HitgroupFunctionNames> hitgroupSbtNames() const;
   virtual anari::Span<const std::string> missSbtNames() const;
 
   virtual void populateFrameData(FrameGPUData &fd) const;
 
-  OptixPipeline pipeline() const;
-  const OptixShaderBindingTable *sbt();
+  // Variant to render a world with the given SceneFeatureFlags with right
+  // now: the specialized one once its modules are compiled, the generic one
+  // (see genericSceneFeatures()) while they compile in the background or if
+  // the specialization is refused
+  uint32_t pipelineVariant(uint32_t sceneFeatures);
+
+  // Pipeline variant specialized for the given SceneFeatureFlags
+  OptixPipeline pipeline(uint32_t sceneFeatures = SCENE_FEATURES_ALL);
+  const OptixShaderBindingTable *sbt(
+      uint32_t sceneFeatures = SCENE_FEATURES_ALL);
 
   vec4 bgColor() const;
   int spp() const;
@@ -84,21 +95,20 @@ struct Renderer : public Object
  protected:
   vec4 m_bgColor{1.f};
   int m_spp{1};
+  uint8_t m_visibilityMask{0xFF};
 
   // OptiX //
 
-  OptixPipeline m_pipeline{nullptr};
-
-  std::vector<OptixProgramGroup> m_raygenPGs;
-  std::vector<OptixProgramGroup> m_missPGs;
-  std::vector<OptixProgramGroup> m_hitgroupPGs;
-  DeviceBuffer m_raygenRecordsBuffer;
-  DeviceBuffer m_missRecordsBuffer;
-  DeviceBuffer m_hitgroupRecordsBuffer;
-  OptixShaderBindingTable m_sbt{};
+  // per scene feature variant, shared with other renderers using identical
+  // programs (see pipelineKey())
+  std::map<uint32_t, std::shared_ptr<SharedOptixPipeline>> m_pipelines;
 
  private:
-  void initOptixPipeline();
+  std::string pipelineKey(uint32_t sceneFeatures) const;
+  SharedOptixPipeline &optixPipeline(uint32_t sceneFeatures);
+  std::shared_ptr<SharedOptixPipeline> initOptixPipeline(
+      uint32_t sceneFeatures);
+  void buildOptixPipeline(SharedOptixPipeline &p, uint32_t sceneFeatures);
 
   HitgroupFunctionNames m_defaultHitgroupNames;
   std::string m_defaultMissName{"__miss__"};
@@ -63,7 +63,7 @@ void SciVis::populateFrameData(FrameGPUData &fd) const
   scivis.aoIntensity = m_aoIntensity;
 }
 
-OptixModule SciVis::optixModule() const
+LazyOptixModule &SciVis::optixModule() const
 {
   return deviceState()->rendererModules.scivis;
 }
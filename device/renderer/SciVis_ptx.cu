@@ -52,8 +52,7 @@ DECLARE_FRAME_DATA(frameData)
 RT_FUNCTION bool isOccluded(ScreenSample &ss, Ray r)
 {
   uint32_t o = 0;
-  intersectSurface(
-      ss, r, RayType::SHADOW, &o, OPTIX_RAY_FLAG_DISABLE_CLOSESTHIT);
+  intersectSurface(ss, r, RayType::SHADOW, &o, occlusionRayFlags(frameData));
   return static_cast<bool>(o);
 }
 
@@ -76,6 +75,9 @@ RT_FUNCTION float computeAO(
 
 RT_FUNCTION float attenuation(ScreenSample &ss, Ray r)
 {
+  if (!sceneHasFeature(frameData, SCENE_FEATURE_VOLUMES))
+    return 0.f;
+
   RayAttenuation ra;
   ra.ray = &r;
   intersectVolume(
@@ -89,6 +91,9 @@ RT_FUNCTION vec3 computeLightConrib(ScreenSample &ss, const SurfaceHit &hit)
 
   auto &world = frameData.world;
 
+  if (!sceneHasFeature(frameData, SCENE_FEATURE_LIGHTS))
+    return vec3(0.f);
+
   const vec3 shadePoint = hit.hitpoint + (hit.epsilon * hit.Ng);
 
   vec3 contrib(0.f);
@@ -116,7 +121,9 @@ RT_FUNCTION vec3 computeLightConrib(ScreenSample &ss, const SurfaceHit &hit)
 
 RT_PROGRAM void __closesthit__shadow()
 {
-  // no-op
+  // occlusion rays terminate on the first accepted (i.e. opaque) hit
+  auto &occluded = ray::rayData<uint32_t>();
+  occluded = true;
 }
 
 RT_PROGRAM void __anyhit__shadow()
@@ -125,10 +132,8 @@ RT_PROGRAM void __anyhit__shadow()
     SurfaceHit hit;
     ray::populateSurfaceHit(hit);
     const auto &material = *hit.material;
-    const auto mat_baseColor =
-        getMaterialParameter(frameData, material.baseColor, hit);
-    const auto mat_opacity =
-        getMaterialParameter(frameData, material.opacity, hit);
+    const auto mat_baseColor = getMaterialBaseColor(frameData, material, hit);
+    const auto mat_opacity = getMaterialOpacity(frameData, material, hit);
     if (mat_opacity >= 0.99f) {
       auto &occluded = ray::rayData<uint32_t>();
       occluded = true;
@@ -197,9 +202,9 @@ RT_PROGRAM void __raygen__()
 
       const auto &material = *surfaceHit.material;
       const auto mat_baseColor =
-          getMaterialParameter(frameData, material.baseColor, surfaceHit);
+          getMaterialBaseColor(frameData, material, surfaceHit);
       const auto mat_opacity =
-          getMaterialParameter(frameData, material.opacity, surfaceHit);
+          getMaterialOpacity(frameData, material, surfaceHit);
 
       const float aoFactor = rendererParams.aoSamples > 0
           ? computeAO(ss, ray, surfaceHit) * rendererParams.aoIntensity
@@ -30,6 +30,7 @@
  */
 
 #include "Group.h"
+#include "Instance.h"
 
 namespace visrtx {
 
@@ -77,12 +78,10 @@ bool Group::getProperty(
   if (name == "bounds" && type == ANARI_FLOAT32_BOX3) {
     if (flags & ANARI_WAIT) {
       deviceState()->flushCommitBuffer();
-      rebuildSurfaceBVHs();
-      rebuildVolumeBVH();
+      rebuildBVHs(newTimeStamp());
     }
-    auto bounds = m_triangleBounds;
-    bounds.extend(m_userBounds);
-    bounds.extend(m_volumeBounds);
+    auto bounds = surfaceBounds();
+    bounds.extend(volumeBounds());
     std::memcpy(ptr, &bounds, sizeof(bounds));
     return true;
   }
@@ -109,11 +108,26 @@ void Group::commit()
         make_Span((Volume **)m_volumeData->handles(), m_volumeData->size());
   }
 
+  // extension: groups of instances, built as nested IASes
+  m_instanceData = getParamObject<ObjectArray>("instance");
+
+  m_instances.reset();
+  if (m_instanceData) {
+    m_instances = make_Span(
+        (Instance **)m_instanceData->handles(), m_instanceData->size());
+  }
+
   m_objectUpdates.lastSurfaceBVHBuilt = 0;
   m_objectUpdates.lastVolumeBVHBuilt = 0;
   m_objectUpdates.lastLightRebuild = 0;
 }
 
+void Group::markCommitted()
+{
+  Object::markCommitted();
+  deviceState()->objectUpdates.lastBLASChange = newTimeStamp();
+}
+
 OptixTraversableHandle Group::optixTraversableTriangle() const
 {
   return m_traversableTriangle;
@@ -129,24 +143,29 @@ OptixTraversableHandle Group::optixTraversableVolume() const
   return m_traversableVolume;
 }
 
-anari::Span<const DeviceObjectIndex> Group::surfaceTriangleGPUIndices() const
+OptixTraversableHandle Group::optixTraversableInstanceSurfaces() const
+{
+  return m_traversableInstanceSurfaces;
+}
+
+OptixTraversableHandle Group::optixTraversableInstanceVolumes() const
 {
-  return anari::make_Span(
-      (const DeviceObjectIndex *)m_surfaceTriangleObjectIndices.ptr(),
-      m_surfacesTriangle.size());
+  return m_traversableInstanceVolumes;
 }
 
-anari::Span<const DeviceObjectIndex> Group::surfaceUserGPUIndices() const
+box3 Group::surfaceBounds() const
 {
-  return anari::make_Span(
-      (const DeviceObjectIndex *)m_surfaceUserObjectIndices.ptr(),
-      m_surfacesUser.size());
+  auto bounds = m_triangleBounds;
+  bounds.extend(m_userBounds);
+  bounds.extend(m_instanceSurfaceBounds);
+  return bounds;
 }
 
-anari::Span<const DeviceObjectIndex> Group::volumeGPUIndices() const
+box3 Group::volumeBounds() const
 {
-  return anari::make_Span(
-      (const DeviceObjectIndex *)m_volumeObjectIndices.ptr(), m_volumes.size());
+  auto bounds = m_volumeBounds;
+  bounds.extend(m_instanceVolumeBounds);
+  return bounds;
 }
 
 bool Group::containsTriangleGeometry() const
@@ -169,39 +188,140 @@ bool Group::containsLights() const
   return m_lights.size() > 0;
 }
 
-anari::Span<const DeviceObjectIndex> Group::lightGPUIndices() const
+bool Group::containsInstances() const
+{
+  return m_instances.size() > 0;
+}
+
+anari::Span<Instance *> Group::instances() const
+{
+  return m_instances;
+}
+
+int Group::instancingDepth() const
+{
+  return m_instancingDepth;
+}
+
+size_t Group::numNonOpaqueSurfaces() const
+{
+  return std::count_if(m_surfaces.begin(), m_surfaces.end(), [](auto *s) {
+    return s->material() && !s->material()->isOpaque();
+  });
+}
+
+size_t Group::numLights() const
+{
+  return m_lights.size();
+}
+
+void Group::appendSurfaceLeaves(std::vector<SurfaceLeaf> &leaves) const
 {
-  return anari::make_Span(
-      (const DeviceObjectIndex *)m_lightObjectIndices.ptr(), m_lights.size());
+  if (containsTriangleGeometry()) {
+    SurfaceLeaf leaf;
+    leaf.surfaces = m_surfaceTriangleObjectIndices;
+    if (m_trianglePlan.hasMerges()) {
+      leaf.inputSlots = m_trianglePlan.inputSlots;
+      leaf.slotPrims = m_trianglePlan.slotPrims;
+    }
+    leaves.push_back(leaf);
+  }
+  if (containsUserGeometry()) {
+    SurfaceLeaf leaf;
+    leaf.surfaces = m_surfaceUserObjectIndices;
+    leaves.push_back(leaf);
+  }
+  const auto &nested = m_surfaceLeaves.entries;
+  leaves.insert(leaves.end(), nested.begin(), nested.end());
 }
 
-void Group::rebuildSurfaceBVHs()
+void Group::appendVolumeLeaves(std::vector<VolumeLeaf> &leaves) const
+{
+  if (containsVolumes())
+    leaves.push_back({m_volumeObjectIndices});
+  const auto &nested = m_volumeLeaves.entries;
+  leaves.insert(leaves.end(), nested.begin(), nested.end());
+}
+
+InstancedGroup Group::instancedGroup(
+    InstanceLeafTable<SurfaceLeaf> &surfaceLeaves,
+    InstanceLeafTable<VolumeLeaf> &volumeLeaves) const
+{
+  InstancedGroup g;
+
+  g.surfaceID = surfaceLeaves.blockOffset(
+      this, [&](auto &leaves) { appendSurfaceLeaves(leaves); });
+  if (containsTriangleGeometry())
+    g.surfaces[g.numSurfaces++] = optixTraversableTriangle();
+  if (containsUserGeometry())
+    g.surfaces[g.numSurfaces++] = optixTraversableUser();
+  if (auto handle = optixTraversableInstanceSurfaces())
+    g.surfaces[g.numSurfaces++] = handle;
+
+  g.volumeID = volumeLeaves.blockOffset(
+      this, [&](auto &leaves) { appendVolumeLeaves(leaves); });
+  if (containsVolumes())
+    g.volumes[g.numVolumes++] = optixTraversableVolume();
+  if (auto handle = optixTraversableInstanceVolumes())
+    g.volumes[g.numVolumes++] = handle;
+
+  g.hasLights = containsLights();
+  g.lightIndices = m_lightObjectIndices;
+
+  return g;
+}
+
+void Group::rebuildBVHs(TimeStamp pass, int depth)
+{
+  if (m_objectUpdates.lastBVHPass >= pass)
+    return;
+
+  rebuildSurfaceBVHs(depth);
+  rebuildVolumeBVH();
+  rebuildLights();
+  rebuildInstanceBVHs(pass, depth);
+
+  m_objectUpdates.lastBVHPass = pass;
+}
+
+void Group::rebuildSurfaceBVHs(int depth)
 {
   if (!m_surfaces) {
+    m_surfacesTriangle.clear();
+    m_surfacesUser.clear();
+    m_surfacesSplit.clear();
+    m_splitSurfaces.clear();
+    m_trianglePlan = {};
+    m_userPlan = {};
     m_triangleBounds = box3();
     m_userBounds = box3();
     m_traversableTriangle = {};
     m_traversableUser = {};
+    m_blasTriangle.reset();
+    m_blasUser.reset();
     reportMessage(
         ANARI_SEVERITY_DEBUG, "visrtx::Group skipping surface BVH build");
     return;
   }
 
-  reportMessage(ANARI_SEVERITY_DEBUG, "visrtx::Group building triangle BVH");
-  buildOptixBVH(createOBI(m_surfacesTriangle),
-      m_bvhTriangle,
-      m_traversableTriangle,
-      m_triangleBounds,
-      this);
+  // triangle counts may have changed since the group was committed
+  partitionGeometriesByType(depth < MAX_NESTED_INSTANCING_DEPTH);
 
-  reportMessage(ANARI_SEVERITY_DEBUG, "visrtx::Group building user BVH");
-  buildOptixBVH(createOBI(m_surfacesUser),
-      m_bvhUser,
+  acquireSurfaceBLAS(m_surfacesTriangle,
+      true,
+      m_trianglePlan,
+      m_blasTriangle,
+      m_traversableTriangle,
+      m_triangleBounds);
+  acquireSurfaceBLAS(m_surfacesUser,
+      false,
+      m_userPlan,
+      m_blasUser,
       m_traversableUser,
-      m_userBounds,
-      this);
+      m_userBounds);
 
-  buildSurfaceGPUData();
+  buildSplitSurfaceBVHs();
+  buildSurfaceIndices();
 
   m_objectUpdates.lastSurfaceBVHBuilt = newTimeStamp();
 }
@@ -223,7 +343,7 @@ void Group::rebuildVolumeBVH()
       m_volumeBounds,
       this);
 
-  buildVolumeGPUData();
+  buildVolumeIndices();
 
   m_objectUpdates.lastVolumeBVHBuilt = newTimeStamp();
 }
@@ -231,67 +351,366 @@ void Group::rebuildVolumeBVH()
 void Group::rebuildLights()
 {
   m_lights.reset();
-  if (m_lightData) {
+  if (m_lightData)
     m_lights = make_Span((Light **)m_lightData->handles(), m_lightData->size());
-    buildLightGPUData();
-  }
+  buildLightIndices();
   m_objectUpdates.lastLightRebuild = newTimeStamp();
 }
 
-void Group::partitionGeometriesByType()
+void Group::rebuildInstanceBVHs(TimeStamp pass, int depth)
+{
+  m_surfaceLeaves.clear();
+  m_volumeLeaves.clear();
+  m_snapshot.clear();
+  m_placedInstances.clear();
+  m_instanceSurfaceBounds = box3();
+  m_instanceVolumeBounds = box3();
+  m_traversableInstanceSurfaces = {};
+  m_traversableInstanceVolumes = {};
+  m_instancingDepth = 0;
+
+  if (!m_instances && m_splitSurfaces.empty())
+    return;
+
+  // chunks of split surfaces, placed after the instances' OptixInstances
+  std::vector<OptixInstance> chunkInstances;
+  const mat3x4 identity = glm::transpose(mat4x3(1.f));
+  for (const auto &ss : m_splitSurfaces) {
+    for (size_t c = 0; c < ss->chunks.size(); c++) {
+      const auto &chunk = *ss->chunks[c];
+      const auto id = m_surfaceLeaves.blockOffset(&chunk, [&](auto &leaves) {
+        SurfaceLeaf leaf;
+        leaf.surfaces = IndexList((const uint32_t *)&ss->surfaceIndex, 1);
+        leaf.primIDs =
+            (const uint32_t *)ss->primIDs.ptr() + ss->chunkOffsets[c];
+        leaves.push_back(leaf);
+      });
+      chunkInstances.push_back(
+          makeOptixInstance(identity, chunk.traversable, id));
+    }
+  }
+
+  if (!chunkInstances.empty())
+    m_instancingDepth = 1;
+
+  auto instances = m_instances;
+  if (instances && depth >= MAX_NESTED_INSTANCING_DEPTH) {
+    reportMessage(ANARI_SEVERITY_ERROR,
+        "visrtx::Group instances nested deeper than %i levels are ignored",
+        MAX_NESTED_INSTANCING_DEPTH);
+    instances.reset();
+  }
+
+  m_buildingInstances = true;
+
+  std::for_each(instances.begin(), instances.end(), [&](auto *inst) {
+    auto *group = inst ? inst->group() : nullptr;
+    if (!group)
+      return;
+    if (group->m_buildingInstances) {
+      reportMessage(ANARI_SEVERITY_ERROR,
+          "visrtx::Group ignoring cyclic instance of a group");
+      return;
+    }
+
+    group->rebuildBVHs(pass, depth + 1);
+
+    if (group->containsLights()) {
+      reportMessage(ANARI_SEVERITY_WARNING,
+          "visrtx::Group lights in nested instances are ignored");
+    }
+
+    m_instancingDepth =
+        std::max(m_instancingDepth, group->instancingDepth() + 1);
+    inst->addToSnapshot(m_snapshot, m_surfaceLeaves, m_volumeLeaves);
+    m_placedInstances.push_back(inst);
+  });
+
+  m_buildingInstances = false;
+
+  m_snapshot.computeOffsets();
+  uploadOptixInstances(m_snapshot,
+      m_placedInstances,
+      m_optixSurfaceInstances,
+      m_optixVolumeInstances,
+      chunkInstances);
+
+  reportMessage(ANARI_SEVERITY_DEBUG,
+      "visrtx::Group building nested surface BVH over %zu instances",
+      m_optixSurfaceInstances.size());
+  buildOptixBVH(instanceBuildInput(m_optixSurfaceInstances),
+      m_bvhInstanceSurfaces,
+      m_traversableInstanceSurfaces,
+      m_instanceSurfaceBounds,
+      this,
+      true);
+
+  reportMessage(ANARI_SEVERITY_DEBUG,
+      "visrtx::Group building nested volume BVH over %zu instances",
+      m_optixVolumeInstances.size());
+  buildOptixBVH(instanceBuildInput(m_optixVolumeInstances),
+      m_bvhInstanceVolumes,
+      m_traversableInstanceVolumes,
+      m_instanceVolumeBounds,
+      this,
+      true);
+}
+
+void Group::updateVisibilityMasks(TimeStamp pass)
+{
+  if (m_objectUpdates.lastVisibilityPass >= pass)
+    return;
+
+  m_objectUpdates.lastVisibilityPass = pass;
+
+  std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
+    if (auto *group = inst ? inst->group() : nullptr)
+      group->updateVisibilityMasks(pass);
+  });
+
+  if (!uploadVisibilityMasks(m_snapshot,
+          m_placedInstances,
+          m_optixSurfaceInstances,
+          m_optixVolumeInstances)) {
+    return;
+  }
+
+  reportMessage(ANARI_SEVERITY_DEBUG,
+      "visrtx::Group refitting nested BVHs for visibility changes");
+  refitOptixBVH(instanceBuildInput(m_optixSurfaceInstances),
+      m_bvhInstanceSurfaces,
+      m_traversableInstanceSurfaces,
+      this);
+  refitOptixBVH(instanceBuildInput(m_optixVolumeInstances),
+      m_bvhInstanceVolumes,
+      m_traversableInstanceVolumes,
+      this);
+}
+
+void Group::acquireSurfaceBLAS(const std::vector<Surface *> &surfaces,
+    bool mergeSmallSurfaces,
+    TriangleMergePlan &plan,
+    std::shared_ptr<CachedBLAS> &blas,
+    OptixTraversableHandle &traversable,
+    box3 &bounds)
+{
+  plan = {};
+
+  if (surfaces.empty()) {
+    blas.reset();
+    traversable = {};
+    bounds = box3();
+    return;
+  }
+
+  // also refreshes each surface's geometry flags used for merging and the key
+  auto surfaceInputs = createOBI(surfaces);
+
+  std::vector<size_t> numTriangles(surfaces.size(), 0);
+  std::vector<uint32_t> flags(surfaces.size());
+  std::vector<bool> mergeable(surfaces.size());
+  for (size_t i = 0; i < surfaces.size(); i++) {
+    TriangleMesh mesh;
+    mergeable[i] =
+        mergeSmallSurfaces && surfaces[i]->geometry()->triangleMesh(mesh);
+    numTriangles[i] = mesh.numTriangles;
+    flags[i] = surfaces[i]->geometryFlags();
+  }
+  plan = planTriangleMerge(numTriangles, flags, mergeable);
+
+  if (plan.hasMerges()) {
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "visrtx::Group merged %zu surfaces into %zu build inputs",
+        plan.numSlots(),
+        plan.numInputs());
+  }
+
+  BLASKey key;
+  key.inputSlots = plan.inputSlots;
+  for (auto i : plan.slotSurfaces) {
+    const auto *s = surfaces[i];
+    const auto *g = s->geometry();
+    key.inputs.push_back({g, g->lastCommitted(), s->geometryFlags()});
+  }
+
+  // the previous BVH is only released after acquiring, so an unchanged key
+  // reuses it
+  auto &cache = deviceState()->blasCache;
+  blas = cache.acquire(key, [&](CachedBLAS &b) {
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "visrtx::Group building BVH over %zu surfaces",
+        surfaces.size());
+
+    // merged positions are only needed until the build completes
+    std::vector<DeviceBuffer> mergedVertices(plan.numInputs());
+    std::vector<DeviceBuffer> mergedIndices(plan.numInputs());
+    std::vector<CUdeviceptr> mergedVertexPtrs(plan.numInputs());
+
+    std::vector<OptixBuildInput> buildInput;
+    for (size_t i = 0; i < plan.numInputs(); i++) {
+      const auto firstSlot = plan.inputSlots[i];
+      auto obi = surfaceInputs[plan.slotSurfaces[firstSlot]];
+
+      if (plan.inputIsMerged(i)) {
+        MergedTriangles merged;
+        for (auto s = firstSlot; s < plan.inputSlots[i + 1]; s++) {
+          TriangleMesh mesh;
+          surfaces[plan.slotSurfaces[s]]->geometry()->triangleMesh(mesh);
+          merged.append(mesh);
+        }
+
+        mergedVertices[i].upload(merged.vertices);
+        mergedIndices[i].upload(merged.indices);
+        mergedVertexPtrs[i] = (CUdeviceptr)mergedVertices[i].ptr();
+
+        // the geometry flags of all merged surfaces are the same
+        auto &tri = obi.triangleArray;
+        tri.vertexBuffers = &mergedVertexPtrs[i];
+        tri.numVertices = merged.vertices.size();
+        tri.indexFormat = OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
+        tri.indexStrideInBytes = sizeof(uvec3);
+        tri.numIndexTriplets = merged.indices.size();
+        tri.indexBuffer = (CUdeviceptr)mergedIndices[i].ptr();
+      }
+
+      buildInput.push_back(obi);
+    }
+
+    buildOptixBVH(buildInput, b.bvh, b.traversable, b.bounds, this);
+    return b.bvh.bytes();
+  });
+
+  reportMessage(ANARI_SEVERITY_DEBUG,
+      "visrtx::Group using cached BVH (%li references, cache: %zu BVHs "
+      "in %zu bytes)",
+      cache.refCount(key),
+      cache.numEntries(),
+      cache.bytes());
+
+  traversable = blas->traversable;
+  bounds = blas->bounds;
+}
+
+void Group::partitionGeometriesByType(bool splitLargeMeshes)
 {
   m_surfacesTriangle.clear();
   m_surfacesUser.clear();
+  m_surfacesSplit.clear();
   for (auto s : m_surfaces) {
     auto g = s->geometry();
-    if (g->optixGeometryType() == OPTIX_BUILD_INPUT_TYPE_TRIANGLES)
-      m_surfacesTriangle.push_back(s);
-    else
+    TriangleMesh mesh;
+    if (g->optixGeometryType() != OPTIX_BUILD_INPUT_TYPE_TRIANGLES)
       m_surfacesUser.push_back(s);
+    else if (splitLargeMeshes && g->triangleMesh(mesh)
+        && mesh.numTriangles > MAX_BLAS_TRIANGLES)
+      m_surfacesSplit.push_back(s);
+    else
+      m_surfacesTriangle.push_back(s);
   }
 }
 
-void Group::buildSurfaceGPUData()
+void Group::buildSplitSurfaceBVHs()
 {
-  auto populateData = [](auto g) { return g->gpuData(); };
+  auto previous = std::move(m_splitSurfaces);
+  m_splitSurfaces.clear();
+
+  for (auto *s : m_surfacesSplit) {
+    const auto obi = s->buildInput();
+    const auto *g = s->geometry();
+
+    auto unchanged = std::find_if(
+        previous.begin(), previous.end(), [&](const auto &p) {
+          return p && p->surface == s && p->geometry == g
+              && p->geometryCommitted == g->lastCommitted()
+              && p->geometryFlags == s->geometryFlags();
+        });
+    if (unchanged != previous.end()) {
+      m_splitSurfaces.push_back(std::move(*unchanged));
+      continue;
+    }
 
-  if (!m_surfacesTriangle.empty()) {
-    std::vector<DeviceObjectIndex> tmp(m_surfacesTriangle.size());
-    std::transform(m_surfacesTriangle.begin(),
-        m_surfacesTriangle.end(),
-        tmp.begin(),
-        [](auto v) { return v->index(); });
-    m_surfaceTriangleObjectIndices.upload(tmp);
-  } else
-    m_surfaceTriangleObjectIndices.reset();
+    TriangleMesh mesh;
+    g->triangleMesh(mesh);
+    const auto split = splitTriangleMesh(mesh);
+
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "visrtx::Group splitting surface of %zu triangles into %zu BVHs",
+        mesh.numTriangles,
+        split.numChunks());
+
+    auto ss = std::make_unique<SplitSurface>();
+    ss->surface = s;
+    ss->geometry = g;
+    ss->geometryCommitted = g->lastCommitted();
+    ss->geometryFlags = s->geometryFlags();
+
+    ss->surfaceIndex = s->index();
+    ss->primIDs.upload(split.primIDs);
+    ss->chunkOffsets = split.chunkOffsets;
+
+    // Chunks are built one after another, bounding the build's scratch memory
+    // by the chunk size, while the indices of the next chunk are gathered
+    auto gather = [&](size_t c) {
+      return std::async(std::launch::async,
+          [&, c]() { return chunkIndices(mesh, split, c); });
+    };
+
+    auto nextIndices = gather(0);
+    for (size_t c = 0; c < split.numChunks(); c++) {
+      DeviceBuffer indices;
+      indices.upload(nextIndices.get());
+      if (c + 1 < split.numChunks())
+        nextIndices = gather(c + 1);
+
+      auto chunkInput = obi;
+      auto &tri = chunkInput.triangleArray;
+      tri.indexFormat = OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
+      tri.indexStrideInBytes = sizeof(uvec3);
+      tri.numIndexTriplets = split.chunkSize(c);
+      tri.indexBuffer = (CUdeviceptr)indices.ptr();
+
+      auto chunk = std::make_unique<CachedBLAS>();
+      buildOptixBVH(
+          {chunkInput}, chunk->bvh, chunk->traversable, chunk->bounds, this);
+      ss->chunks.push_back(std::move(chunk));
+    }
 
-  if (!m_surfacesUser.empty()) {
-    std::vector<DeviceObjectIndex> tmp(m_surfacesUser.size());
-    std::transform(
-        m_surfacesUser.begin(), m_surfacesUser.end(), tmp.begin(), [](auto v) {
-          return v->index();
-        });
-    m_surfaceUserObjectIndices.upload(tmp);
-  } else
-    m_surfaceUserObjectIndices.reset();
+    m_splitSurfaces.push_back(std::move(ss));
+  }
 }
 
-void Group::buildVolumeGPUData()
+void Group::buildSurfaceIndices()
 {
-  std::vector<DeviceObjectIndex> tmp(m_volumes.size());
-  std::transform(m_volumes.begin(), m_volumes.end(), tmp.begin(), [](auto v) {
-    return v->index();
-  });
-  m_volumeObjectIndices.upload(tmp);
+  const auto &slots = m_trianglePlan.slotSurfaces;
+  m_surfaceTriangleObjectIndices.resize(slots.size());
+  std::transform(slots.begin(),
+      slots.end(),
+      m_surfaceTriangleObjectIndices.begin(),
+      [&](auto i) { return m_surfacesTriangle[i]->index(); });
+
+  m_surfaceUserObjectIndices.resize(m_surfacesUser.size());
+  std::transform(m_surfacesUser.begin(),
+      m_surfacesUser.end(),
+      m_surfaceUserObjectIndices.begin(),
+      [](auto v) { return v->index(); });
 }
 
-void Group::buildLightGPUData()
+void Group::buildVolumeIndices()
 {
-  std::vector<DeviceObjectIndex> tmp(m_lights.size());
-  std::transform(m_lights.begin(), m_lights.end(), tmp.begin(), [](auto l) {
-    return l->index();
-  });
-  m_lightObjectIndices.upload(tmp);
+  m_volumeObjectIndices.resize(m_volumes.size());
+  std::transform(m_volumes.begin(),
+      m_volumes.end(),
+      m_volumeObjectIndices.begin(),
+      [](auto v) { return v->index(); });
+}
+
+void Group::buildLightIndices()
+{
+  m_lightObjectIndices.resize(m_lights.size());
+  std::transform(m_lights.begin(),
+      m_lights.end(),
+      m_lightObjectIndices.begin(),
+      [](auto l) { return l->index(); });
 }
 
 } // namespace visrtx
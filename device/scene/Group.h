@@ -31,6 +31,10 @@
 
 #pragma once
 
+#include "InstanceLeafTable.h"
+#include "InstanceSnapshot.h"
+#include "MeshSplit.h"
+#include "TriangleMerge.h"
 #include "array/ObjectArray.h"
 #include "light/Light.h"
 #include "surface/Surface.h"
@@ -39,6 +43,8 @@
 
 namespace visrtx {
 
+struct Instance;
+
 struct Group : public Object
 {
   static size_t objectCount();
@@ -52,30 +58,68 @@ struct Group : public Object
       uint32_t flags) override;
 
   void commit() override;
+  void markCommitted() override;
 
   OptixTraversableHandle optixTraversableTriangle() const;
   OptixTraversableHandle optixTraversableUser() const;
   OptixTraversableHandle optixTraversableVolume() const;
+  OptixTraversableHandle optixTraversableInstanceSurfaces() const;
+  OptixTraversableHandle optixTraversableInstanceVolumes() const;
+
+  box3 surfaceBounds() const;
+  box3 volumeBounds() const;
 
   bool containsTriangleGeometry() const;
   bool containsUserGeometry() const;
   bool containsVolumes() const;
   bool containsLights() const;
+  bool containsInstances() const;
+
+  anari::Span<Instance *> instances() const;
+  // Number of nested IAS levels below this group (0 without instances)
+  int instancingDepth() const;
+
+  size_t numNonOpaqueSurfaces() const;
+  size_t numLights() const;
+
+  // Instance data of this group's GASes followed by that of its nested
+  // instances, see InstanceLeafTable. The index lists they reference are owned
+  // by the groups and packed by the world, see PackedIndexTable.
+  void appendSurfaceLeaves(std::vector<SurfaceLeaf> &leaves) const;
+  void appendVolumeLeaves(std::vector<VolumeLeaf> &leaves) const;
 
-  anari::Span<const DeviceObjectIndex> surfaceTriangleGPUIndices() const;
-  anari::Span<const DeviceObjectIndex> surfaceUserGPUIndices() const;
-  anari::Span<const DeviceObjectIndex> volumeGPUIndices() const;
-  anari::Span<const DeviceObjectIndex> lightGPUIndices() const;
+  // BVHs and lights placed by instances of this group, registering its
+  // instance data in the given tables
+  InstancedGroup instancedGroup(InstanceLeafTable<SurfaceLeaf> &surfaceLeaves,
+      InstanceLeafTable<VolumeLeaf> &volumeLeaves) const;
 
-  void rebuildSurfaceBVHs();
+  // Rebuild every BVH of this group and its nested groups, at most once for
+  // each 'pass' time stamp
+  void rebuildBVHs(TimeStamp pass, int depth = 0);
+
+  // Patch changed visibility masks of nested instances (recursively) and refit
+  // the nested IASes, at most once for each 'pass' time stamp
+  void updateVisibilityMasks(TimeStamp pass);
+
+  // Oversized triangle meshes are only split into several GASes (placed by an
+  // extra IAS level) at nesting depths which leave room for that level
+  void rebuildSurfaceBVHs(int depth = 0);
   void rebuildVolumeBVH();
   void rebuildLights();
 
  private:
-  void partitionGeometriesByType();
-  void buildSurfaceGPUData();
-  void buildVolumeGPUData();
-  void buildLightGPUData();
+  void partitionGeometriesByType(bool splitLargeMeshes = false);
+  void buildSplitSurfaceBVHs();
+  void buildSurfaceIndices();
+  void buildVolumeIndices();
+  void buildLightIndices();
+  void rebuildInstanceBVHs(TimeStamp pass, int depth);
+  void acquireSurfaceBLAS(const std::vector<Surface *> &surfaces,
+      bool mergeSmallSurfaces,
+      TriangleMergePlan &plan,
+      std::shared_ptr<CachedBLAS> &blas,
+      OptixTraversableHandle &traversable,
+      box3 &bounds);
 
   // Geometry //
 
@@ -84,23 +128,60 @@ struct Group : public Object
 
   std::vector<Surface *> m_surfacesTriangle;
   std::vector<Surface *> m_surfacesUser;
+  std::vector<Surface *> m_surfacesSplit;
+
+  // triangle surfaces are addressed by the slots of their merge plan
+  TriangleMergePlan m_trianglePlan;
+  TriangleMergePlan m_userPlan;
+
+  std::vector<DeviceObjectIndex> m_surfaceTriangleObjectIndices;
+  std::vector<DeviceObjectIndex> m_surfaceUserObjectIndices;
 
-  DeviceBuffer m_surfaceTriangleObjectIndices;
-  DeviceBuffer m_surfaceUserObjectIndices;
+  // Oversized triangle surfaces, each split into one GAS per chunk (see
+  // MeshSplit) which the nested surface IAS places untransformed
+  struct SplitSurface
+  {
+    const Surface *surface{nullptr};
+    const Geometry *geometry{nullptr};
+    TimeStamp geometryCommitted{0};
+    uint32_t geometryFlags{0};
+
+    DeviceObjectIndex surfaceIndex{-1};
+    DeviceBuffer primIDs;
+    std::vector<uint32_t> chunkOffsets;
+    std::vector<std::unique_ptr<CachedBLAS>> chunks;
+  };
+
+  std::vector<std::unique_ptr<SplitSurface>> m_splitSurfaces;
 
   // Volume //
 
   anari::IntrusivePtr<ObjectArray> m_volumeData;
   anari::Span<Volume *> m_volumes;
 
-  DeviceBuffer m_volumeObjectIndices;
+  std::vector<DeviceObjectIndex> m_volumeObjectIndices;
 
   // Light //
 
   anari::IntrusivePtr<ObjectArray> m_lightData;
   anari::Span<Light *> m_lights;
 
-  DeviceBuffer m_lightObjectIndices;
+  std::vector<DeviceObjectIndex> m_lightObjectIndices;
+
+  // Nested instances //
+
+  anari::IntrusivePtr<ObjectArray> m_instanceData;
+  anari::Span<Instance *> m_instances;
+
+  InstanceLeafTable<SurfaceLeaf> m_surfaceLeaves;
+  InstanceLeafTable<VolumeLeaf> m_volumeLeaves;
+  HostDeviceArray<OptixInstance> m_optixSurfaceInstances;
+  HostDeviceArray<OptixInstance> m_optixVolumeInstances;
+  InstanceSnapshot m_snapshot;
+  std::vector<const Instance *> m_placedInstances;
+
+  int m_instancingDepth{0};
+  bool m_buildingInstances{false};
 
   // BVH //
 
@@ -109,20 +190,31 @@ struct Group : public Object
     TimeStamp lastSurfaceBVHBuilt{0};
     TimeStamp lastVolumeBVHBuilt{0};
     TimeStamp lastLightRebuild{0};
+    TimeStamp lastBVHPass{0};
+    TimeStamp lastVisibilityPass{0};
   } m_objectUpdates;
 
   box3 m_triangleBounds;
   box3 m_userBounds;
   box3 m_volumeBounds;
+  box3 m_instanceSurfaceBounds;
+  box3 m_instanceVolumeBounds;
 
+  // surface GASes are shared through DeviceGlobalState::blasCache
   OptixTraversableHandle m_traversableTriangle{};
-  DeviceBuffer m_bvhTriangle;
+  std::shared_ptr<CachedBLAS> m_blasTriangle;
 
   OptixTraversableHandle m_traversableUser{};
-  DeviceBuffer m_bvhUser;
+  std::shared_ptr<CachedBLAS> m_blasUser;
 
   OptixTraversableHandle m_traversableVolume{};
   DeviceBuffer m_bvhVolume;
+
+  OptixTraversableHandle m_traversableInstanceSurfaces{};
+  DeviceBuffer m_bvhInstanceSurfaces;
+
+  OptixTraversableHandle m_traversableInstanceVolumes{};
+  DeviceBuffer m_bvhInstanceVolumes;
 };
 
 } // namespace visrtx
@@ -33,6 +33,65 @@
 
 namespace visrtx {
 
+void uploadOptixInstances(InstanceSnapshot &snapshot,
+    const std::vector<const Instance *> &instances,
+    HostDeviceArray<OptixInstance> &surfaces,
+    HostDeviceArray<OptixInstance> &volumes,
+    const std::vector<OptixInstance> &extraSurfaces)
+{
+  snapshot.gatherTransforms(
+      [&](size_t i, size_t t) { return instances[i]->xfm(t); });
+
+  const size_t numSurfaces = snapshot.numSurfaceInstances();
+  surfaces.resize(numSurfaces + extraSurfaces.size());
+  volumes.resize(snapshot.numVolumeInstances());
+  snapshot.writeOptixInstances(surfaces.dataHost(), volumes.dataHost());
+  std::copy(extraSurfaces.begin(),
+      extraSurfaces.end(),
+      surfaces.dataHost() + numSurfaces);
+
+  surfaces.upload();
+  volumes.upload();
+}
+
+bool uploadVisibilityMasks(InstanceSnapshot &snapshot,
+    const std::vector<const Instance *> &instances,
+    HostDeviceArray<OptixInstance> &surfaces,
+    HostDeviceArray<OptixInstance> &volumes)
+{
+  const bool changed = snapshot.updateMasks(
+      [&](size_t i) { return instances[i]->visibilityMask(); });
+
+  if (changed) {
+    snapshot.writeMasks(surfaces.dataHost(), volumes.dataHost());
+    surfaces.upload();
+    volumes.upload();
+  }
+
+  return changed;
+}
+
+std::vector<OptixBuildInput> instanceBuildInput(
+    HostDeviceArray<OptixInstance> &optixInstances)
+{
+  auto optixInstancesDevice = optixInstances.deviceSpan();
+  auto numInstances = optixInstancesDevice.size();
+
+  if (numInstances == 0)
+    return {};
+
+  OptixBuildInput buildInput{};
+
+  buildInput.type = OPTIX_BUILD_INPUT_TYPE_INSTANCES;
+  buildInput.instanceArray.instances =
+      numInstances > 0 ? (CUdeviceptr)optixInstancesDevice.data() : 0;
+  buildInput.instanceArray.numInstances = numInstances;
+
+  return {buildInput};
+}
+
+// Instance definitions ///////////////////////////////////////////////////////
+
 static size_t s_numInstances = 0;
 
 size_t Instance::objectCount()
@@ -47,25 +106,74 @@ Instance::Instance()
 
 Instance::~Instance()
 {
+  cleanup();
   s_numInstances--;
 }
 
 void Instance::commit()
 {
+  cleanup();
+
+  const auto lastXfm = m_xfm;
+  const auto *lastXfmArray = m_xfmArray.ptr;
+  const auto lastXfmArrayModified = m_xfmArrayModified;
+  const auto *lastGroup = m_group.ptr;
+  const auto lastVisibilityMask = visibilityMask();
+
   m_xfm = getParam<mat4x3>("transform", getParam<mat4>("transform", mat4(1)));
+
+  // extension: one instance placing its group for every transform in an array
+  m_xfmArray = getParamObject<Array1D>("transform");
+  if (m_xfmArray) {
+    const auto type = m_xfmArray->elementType();
+    if (type != anari::ANARITypeFor<mat4x3>::value
+        && type != anari::ANARITypeFor<mat4>::value) {
+      reportMessage(ANARI_SEVERITY_WARNING,
+          "'transform' array on ANARIInstance must be of 4x3 or 4x4 "
+          "matrices, ignoring it");
+      m_xfmArray = nullptr;
+    } else
+      m_xfmArray->addCommitObserver(this);
+  }
+  m_xfmArrayModified = m_xfmArray ? m_xfmArray->lastModified() : 0;
+
   m_group = getParamObject<Group>("group");
   if (!m_group)
     reportMessage(ANARI_SEVERITY_WARNING, "missing 'group' on ANARIInstance");
+
+  m_visible = getParam<bool>("visible", true);
+  m_visibilityMask = uint8_t(getParam<uint32_t>(
+      "visibilityMask", getParam<uint8_t>("visibilityMask", 0xFF)));
+
+  m_placementChanged = m_xfm != lastXfm || m_xfmArray.ptr != lastXfmArray
+      || m_xfmArrayModified != lastXfmArrayModified
+      || m_group.ptr != lastGroup;
+  m_visibilityChanged = visibilityMask() != lastVisibilityMask;
+}
+
+size_t Instance::numTransforms() const
+{
+  return m_xfmArray ? m_xfmArray->size() : 1;
 }
 
-mat4x3 Instance::xfm() const
+mat4x3 Instance::xfm(size_t i) const
 {
-  return m_xfm;
+  if (!m_xfmArray)
+    return m_xfm;
+  else if (m_xfmArray->elementType() == anari::ANARITypeFor<mat4x3>::value)
+    return m_xfmArray->hostDataAs<mat4x3>()[i];
+  else
+    return mat4x3(m_xfmArray->hostDataAs<mat4>()[i]);
 }
 
 bool Instance::xfmIsIdentity() const
 {
-  return xfm() == mat4x3(1);
+  return numTransforms() == 1 && xfm() == mat4x3(1);
+}
+
+uint8_t Instance::visibilityMask() const
+{
+  return m_visible ? m_visibilityMask : 0;
 }
 
 const Group *Instance::group() const
@@ -78,10 +186,31 @@ Group *Instance::group()
   return m_group.ptr;
 }
 
+void Instance::addToSnapshot(InstanceSnapshot &snapshot,
+    InstanceLeafTable<SurfaceLeaf> &surfaceLeaves,
+    InstanceLeafTable<VolumeLeaf> &volumeLeaves) const
+{
+  const auto *group = this->group();
+  const auto g = snapshot.groupIndex(group,
+      [&]() { return group->instancedGroup(surfaceLeaves, volumeLeaves); });
+  snapshot.addInstance(g, numTransforms(), visibilityMask());
+}
+
 void Instance::markCommitted()
 {
   Object::markCommitted();
-  deviceState()->objectUpdates.lastTLASChange = newTimeStamp();
+  // showing/hiding an instance only patches its OptixInstances' masks
+  auto &updates = deviceState()->objectUpdates;
+  if (m_placementChanged)
+    updates.lastTLASChange = newTimeStamp();
+  else if (m_visibilityChanged)
+    updates.lastVisibilityChange = newTimeStamp();
+}
+
+void Instance::cleanup()
+{
+  if (m_xfmArray)
+    m_xfmArray->removeCommitObserver(this);
 }
 
 } // namespace visrtx
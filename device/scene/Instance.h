@@ -32,6 +32,7 @@
 #pragma once
 
 #include "Group.h"
+#include "array/Array1D.h"
 
 namespace visrtx {
 
@@ -44,19 +45,61 @@ struct Instance : public Object
 
   void commit() override;
 
-  mat4x3 xfm() const;
+  // An instance places its group once per transform, which is either a single
+  // matrix or an array of them
+  size_t numTransforms() const;
+  mat4x3 xfm(size_t i = 0) const;
   bool xfmIsIdentity() const;
 
+  // OptiX visibility mask of every placement, 0 if the instance is hidden
+  uint8_t visibilityMask() const;
+
   const Group *group() const;
   Group *group();
 
+  // Add this instance to 'snapshot', registering its group's data in the given
+  // tables the first time the group is placed. The instance IDs of its
+  // OptixInstances are offsets to that data (see InstanceLeafTable).
+  void addToSnapshot(InstanceSnapshot &snapshot,
+      InstanceLeafTable<SurfaceLeaf> &surfaceLeaves,
+      InstanceLeafTable<VolumeLeaf> &volumeLeaves) const;
+
   void markCommitted() override;
 
  private:
+  void cleanup();
+
   mat4x3 m_xfm;
+  anari::IntrusivePtr<Array1D> m_xfmArray;
+  TimeStamp m_xfmArrayModified{0};
   anari::IntrusivePtr<Group> m_group;
+
+  bool m_visible{true};
+  uint8_t m_visibilityMask{0xFF};
+
+  // what the last commit changed, see markCommitted()
+  bool m_placementChanged{true};
+  bool m_visibilityChanged{false};
 };
 
+// Write (in parallel) and upload the OptixInstances of 'snapshot', in which
+// 'instances' were added in order, followed by 'extraSurfaces'
+void uploadOptixInstances(InstanceSnapshot &snapshot,
+    const std::vector<const Instance *> &instances,
+    HostDeviceArray<OptixInstance> &surfaces,
+    HostDeviceArray<OptixInstance> &volumes,
+    const std::vector<OptixInstance> &extraSurfaces = {});
+
+// Refresh the visibility masks of 'snapshot' from 'instances', uploading the
+// patched OptixInstances if any changed. Returns whether the IAS needs a refit.
+bool uploadVisibilityMasks(InstanceSnapshot &snapshot,
+    const std::vector<const Instance *> &instances,
+    HostDeviceArray<OptixInstance> &surfaces,
+    HostDeviceArray<OptixInstance> &volumes);
+
+std::vector<OptixBuildInput> instanceBuildInput(
+    HostDeviceArray<OptixInstance> &optixInstances);
+
 } // namespace visrtx
 
 VISRTX_ANARI_TYPEFOR_SPECIALIZATION(visrtx::Instance *, ANARI_INSTANCE);
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace visrtx {
+
+// Maximum number of nested IAS levels below the world's TLAS
+constexpr int MAX_NESTED_INSTANCING_DEPTH = 3;
+
+// Instance data tables for (possibly nested) instancing. The instanceId of an
+// OptixInstance is the offset of its data in the table belonging to the IAS
+// containing it. On the device the instance IDs along the transform list are
+// summed (see ray::instID()), so data of a GAS reached through nested IASes is
+// found by composing the offsets of every level. Blocks are registered once per
+// key (i.e. group), so replicating a group doesn't grow the tables.
+template <typename T>
+struct InstanceLeafTable
+{
+  // Offset of the block registered for 'key', appending it with
+  // 'appendBlock(entries)' first if not registered yet
+  template <typename FCN>
+  uint32_t blockOffset(const void *key, FCN &&appendBlock);
+
+  void clear();
+
+  std::vector<T> entries;
+
+ private:
+  std::map<const void *, uint32_t> m_offsets;
+};
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+template <typename T>
+template <typename FCN>
+inline uint32_t InstanceLeafTable<T>::blockOffset(
+    const void *key, FCN &&appendBlock)
+{
+  auto found = m_offsets.find(key);
+  if (found != m_offsets.end())
+    return found->second;
+
+  const auto offset = static_cast<uint32_t>(entries.size());
+  m_offsets[key] = offset;
+  appendBlock(entries);
+  return offset;
+}
+
+template <typename T>
+inline void InstanceLeafTable<T>::clear()
+{
+  entries.clear();
+  m_offsets.clear();
+}
+
+} // namespace visrtx
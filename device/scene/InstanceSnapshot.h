@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "PackedIndexTable.h"
+#include "gpu/gpu_objects.h"
+#include "utility/ParallelFor.h"
+// std
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace visrtx {
+
+inline OptixInstance makeOptixInstance(const mat3x4 &xfm,
+    OptixTraversableHandle handle,
+    uint32_t instanceID,
+    uint8_t visibilityMask = 0xFF)
+{
+  OptixInstance inst{};
+
+  std::memcpy(inst.transform, &xfm, sizeof(xfm));
+
+  inst.traversableHandle = handle;
+  inst.flags = OPTIX_INSTANCE_FLAG_NONE;
+  inst.instanceId = instanceID;
+  inst.sbtOffset = 0;
+  inst.visibilityMask = visibilityMask;
+
+  return inst;
+}
+
+// BVHs (and lights) of a group placed by every instance of it. The instance
+// IDs of consecutive BVHs are consecutive, starting at the offset of the
+// group's block in the InstanceLeafTable. 'lights' is resolved from the
+// group's 'lightIndices' once those are packed (see PackedIndexTable).
+struct InstancedGroup
+{
+  std::array<OptixTraversableHandle, 3> surfaces{};
+  uint32_t numSurfaces{0};
+  uint32_t surfaceID{0};
+
+  std::array<OptixTraversableHandle, 2> volumes{};
+  uint32_t numVolumes{0};
+  uint32_t volumeID{0};
+
+  bool hasLights{false};
+  IndexList lightIndices;
+  InstanceLightGPUData lights{};
+};
+
+// Structure-of-arrays snapshot of a world's instances, from which the TLAS
+// OptixInstances and the light instance data are written in parallel. Each
+// instance writes its outputs starting at the exclusive prefix sums of the
+// output counts of the instances before it, so no two instances share a slot.
+struct InstanceSnapshot
+{
+  void clear();
+
+  // Index of the group registered for 'key', registering 'makeGroup()' first
+  // if not registered yet
+  template <typename FCN>
+  uint32_t groupIndex(const void *key, FCN &&makeGroup);
+
+  void addInstance(
+      uint32_t group, size_t numTransforms, uint8_t visibilityMask = 0xFF);
+
+  // Turn the per-instance counts into offsets, sizing 'xfms'
+  void computeOffsets();
+
+  // Fill 'xfms' with 'xfmOf(instance, i)' (a mat4x3) for every transform
+  template <typename FCN>
+  void gatherTransforms(FCN &&xfmOf);
+
+  void writeOptixInstances(
+      OptixInstance *surfaces, OptixInstance *volumes) const;
+  void writeLightInstances(InstanceLightGPUData *lights) const;
+
+  // Replace 'masks' with 'maskOf(instance)', returning whether any changed
+  template <typename FCN>
+  bool updateMasks(FCN &&maskOf);
+
+  // Patch only the visibility masks of already written OptixInstances
+  void writeMasks(OptixInstance *surfaces, OptixInstance *volumes) const;
+
+  size_t numInstances() const;
+  size_t numSurfaceInstances() const;
+  size_t numVolumeInstances() const;
+  size_t numLightInstances() const;
+
+  std::vector<InstancedGroup> groups;
+
+  // per instance, offsets having one extra entry holding the total
+  std::vector<uint32_t> instanceGroups;
+  std::vector<uint8_t> masks;
+  std::vector<size_t> xfmOffsets{0};
+  std::vector<size_t> surfaceOffsets{0};
+  std::vector<size_t> volumeOffsets{0};
+  std::vector<size_t> lightOffsets{0};
+
+  // per transform, transposed to the layout of OptixInstance::transform
+  std::vector<mat3x4> xfms;
+
+ private:
+  std::unordered_map<const void *, uint32_t> m_groupIndices;
+};
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+inline void InstanceSnapshot::clear()
+{
+  groups.clear();
+  instanceGroups.clear();
+  masks.clear();
+  xfmOffsets.assign(1, 0);
+  surfaceOffsets.assign(1, 0);
+  volumeOffsets.assign(1, 0);
+  lightOffsets.assign(1, 0);
+  xfms.clear();
+  m_groupIndices.clear();
+}
+
+template <typename FCN>
+inline uint32_t InstanceSnapshot::groupIndex(const void *key, FCN &&makeGroup)
+{
+  auto found = m_groupIndices.find(key);
+  if (found != m_groupIndices.end())
+    return found->second;
+
+  const auto index = uint32_t(groups.size());
+  groups.push_back(makeGroup());
+  m_groupIndices[key] = index;
+  return index;
+}
+
+inline void InstanceSnapshot::addInstance(
+    uint32_t group, size_t numTransforms, uint8_t visibilityMask)
+{
+  const auto &g = groups[group];
+  instanceGroups.push_back(group);
+  masks.push_back(visibilityMask);
+  xfmOffsets.push_back(numTransforms);
+  surfaceOffsets.push_back(numTransforms * g.numSurfaces);
+  volumeOffsets.push_back(numTransforms * g.numVolumes);
+  lightOffsets.push_back(g.hasLights ? 1 : 0);
+}
+
+inline void InstanceSnapshot::computeOffsets()
+{
+  for (auto *offsets :
+      {&xfmOffsets, &surfaceOffsets, &volumeOffsets, &lightOffsets}) {
+    std::partial_sum(offsets->begin(), offsets->end(), offsets->begin());
+  }
+  xfms.resize(xfmOffsets.back());
+}
+
+template <typename FCN>
+inline void InstanceSnapshot::gatherTransforms(FCN &&xfmOf)
+{
+  parallelFor(numInstances(), [&](size_t i) {
+    const size_t offset = xfmOffsets[i];
+    const size_t n = xfmOffsets[i + 1] - offset;
+    for (size_t t = 0; t < n; t++)
+      xfms[offset + t] = glm::transpose(mat4x3(xfmOf(i, t)));
+  });
+}
+
+inline void InstanceSnapshot::writeOptixInstances(
+    OptixInstance *surfaces, OptixInstance *volumes) const
+{
+  parallelFor(numInstances(), [&](size_t i) {
+    const auto &g = groups[instanceGroups[i]];
+    const size_t xfmOffset = xfmOffsets[i];
+    const size_t n = xfmOffsets[i + 1] - xfmOffset;
+
+    auto *s = surfaces + surfaceOffsets[i];
+    for (uint32_t b = 0; b < g.numSurfaces; b++) {
+      for (size_t t = 0; t < n; t++) {
+        *s++ = makeOptixInstance(
+            xfms[xfmOffset + t], g.surfaces[b], g.surfaceID + b, masks[i]);
+      }
+    }
+
+    auto *v = volumes + volumeOffsets[i];
+    for (uint32_t b = 0; b < g.numVolumes; b++) {
+      for (size_t t = 0; t < n; t++) {
+        *v++ = makeOptixInstance(
+            xfms[xfmOffset + t], g.volumes[b], g.volumeID + b, masks[i]);
+      }
+    }
+  });
+}
+
+inline void InstanceSnapshot::writeLightInstances(
+    InstanceLightGPUData *lights) const
+{
+  parallelFor(numInstances(), [&](size_t i) {
+    const auto &g = groups[instanceGroups[i]];
+    if (g.hasLights)
+      lights[lightOffsets[i]] = g.lights;
+  });
+}
+
+template <typename FCN>
+inline bool InstanceSnapshot::updateMasks(FCN &&maskOf)
+{
+  std::atomic<bool> changed{false};
+  parallelFor(numInstances(), [&](size_t i) {
+    const uint8_t mask = maskOf(i);
+    if (mask != masks[i]) {
+      masks[i] = mask;
+      changed = true;
+    }
+  });
+  return changed;
+}
+
+inline void InstanceSnapshot::writeMasks(
+    OptixInstance *surfaces, OptixInstance *volumes) const
+{
+  parallelFor(numInstances(), [&](size_t i) {
+    for (size_t s = surfaceOffsets[i]; s < surfaceOffsets[i + 1]; s++)
+      surfaces[s].visibilityMask = masks[i];
+    for (size_t v = volumeOffsets[i]; v < volumeOffsets[i + 1]; v++)
+      volumes[v].visibilityMask = masks[i];
+  });
+}
+
+inline size_t InstanceSnapshot::numInstances() const
+{
+  return instanceGroups.size();
+}
+
+inline size_t InstanceSnapshot::numSurfaceInstances() const
+{
+  return surfaceOffsets.back();
+}
+
+inline size_t InstanceSnapshot::numVolumeInstances() const
+{
+  return volumeOffsets.back();
+}
+
+inline size_t InstanceSnapshot::numLightInstances() const
+{
+  return lightOffsets.back();
+}
+
+} // namespace visrtx
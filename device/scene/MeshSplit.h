@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "TriangleMerge.h"
+#include "utility/ParallelFor.h"
+// std
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace visrtx {
+
+// Triangle meshes with more triangles are split into several GASes
+constexpr size_t MAX_BLAS_TRIANGLES = size_t(1) << 24;
+
+// Partition of a triangle mesh into spatially coherent chunks: triangles are
+// ordered along the Morton curve of their centroids and chunk c holds the
+// triangles primIDs[chunkOffsets[c]] ... primIDs[chunkOffsets[c + 1] - 1].
+struct MeshSplit
+{
+  size_t numChunks() const;
+  size_t chunkSize(size_t chunk) const;
+
+  std::vector<uint32_t> primIDs;
+  std::vector<uint32_t> chunkOffsets{0};
+};
+
+// 30 bit Morton code of a point quantized to 10 bits per axis in 'bounds'
+uint32_t mortonCode(const vec3 &p, const box3 &bounds);
+
+// Split 'mesh' into the fewest equally sized chunks of at most
+// 'maxChunkTriangles' triangles
+MeshSplit splitTriangleMesh(
+    const TriangleMesh &mesh, size_t maxChunkTriangles = MAX_BLAS_TRIANGLES);
+
+// Vertex indices of the triangles in 'chunk', in chunk order
+std::vector<uvec3> chunkIndices(
+    const TriangleMesh &mesh, const MeshSplit &split, size_t chunk);
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+inline size_t MeshSplit::numChunks() const
+{
+  return chunkOffsets.size() - 1;
+}
+
+inline size_t MeshSplit::chunkSize(size_t chunk) const
+{
+  return chunkOffsets[chunk + 1] - chunkOffsets[chunk];
+}
+
+namespace detail {
+
+inline uint32_t spreadBits10(uint32_t v)
+{
+  v &= 0x3FF;
+  v = (v | (v << 16)) & 0x030000FF;
+  v = (v | (v << 8)) & 0x0300F00F;
+  v = (v | (v << 4)) & 0x030C30C3;
+  v = (v | (v << 2)) & 0x09249249;
+  return v;
+}
+
+} // namespace detail
+
+inline uint32_t mortonCode(const vec3 &p, const box3 &bounds)
+{
+  const vec3 extent = glm::max(bounds.upper - bounds.lower, vec3(1e-20f));
+  const vec3 n = glm::clamp((p - bounds.lower) / extent, vec3(0.f), vec3(1.f));
+  const uvec3 q = uvec3(n * 1023.f);
+  return (detail::spreadBits10(q.x) << 2) | (detail::spreadBits10(q.y) << 1)
+      | detail::spreadBits10(q.z);
+}
+
+inline MeshSplit splitTriangleMesh(
+    const TriangleMesh &mesh, size_t maxChunkTriangles)
+{
+  MeshSplit split;
+
+  const size_t numTriangles = mesh.numTriangles;
+  if (numTriangles == 0)
+    return split;
+
+  auto centroid = [&](size_t i) {
+    const uvec3 idx = mesh.triangle(i);
+    return (mesh.vertices[idx.x] + mesh.vertices[idx.y] + mesh.vertices[idx.z])
+        / 3.f;
+  };
+
+  box3 bounds;
+  for (size_t i = 0; i < mesh.numVertices; i++)
+    bounds.extend(mesh.vertices[i]);
+
+  // Morton code in the upper, triangle index in the lower 32 bits, so sorting
+  // the keys orders the triangles along the curve (ties by index)
+  std::vector<uint64_t> keys(numTriangles);
+  parallelFor(numTriangles, [&](size_t i) {
+    keys[i] = (uint64_t(mortonCode(centroid(i), bounds)) << 32) | i;
+  });
+
+  // bucket by the top 10 code bits, then sort the buckets in parallel
+  constexpr size_t numBuckets = 1024;
+  auto bucketOf = [](uint64_t key) { return size_t(key >> 52); };
+
+  std::vector<size_t> bucketOffsets(numBuckets + 1, 0);
+  for (auto k : keys)
+    bucketOffsets[bucketOf(k) + 1]++;
+  for (size_t b = 0; b < numBuckets; b++)
+    bucketOffsets[b + 1] += bucketOffsets[b];
+
+  std::vector<uint64_t> sorted(numTriangles);
+  auto next = bucketOffsets;
+  for (auto k : keys)
+    sorted[next[bucketOf(k)]++] = k;
+  keys = {};
+
+  parallelFor(
+      numBuckets,
+      [&](size_t b) {
+        std::sort(sorted.begin() + bucketOffsets[b],
+            sorted.begin() + bucketOffsets[b + 1]);
+      },
+      1);
+
+  split.primIDs.resize(numTriangles);
+  parallelFor(
+      numTriangles, [&](size_t i) { split.primIDs[i] = uint32_t(sorted[i]); });
+
+  const size_t numChunks =
+      (numTriangles + maxChunkTriangles - 1) / maxChunkTriangles;
+  for (size_t c = 1; c <= numChunks; c++)
+    split.chunkOffsets.push_back(uint32_t(c * numTriangles / numChunks));
+
+  return split;
+}
+
+inline std::vector<uvec3> chunkIndices(
+    const TriangleMesh &mesh, const MeshSplit &split, size_t chunk)
+{
+  const uint32_t *primIDs = split.primIDs.data() + split.chunkOffsets[chunk];
+  std::vector<uvec3> indices(split.chunkSize(chunk));
+  parallelFor(indices.size(), [&](size_t i) {
+    indices[i] = mesh.triangle(primIDs[i]);
+  });
+  return indices;
+}
+
+} // namespace visrtx
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "gpu/gpu_objects.h"
+// std
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace visrtx {
+
+// Host view of a (small) per-group table of 32-bit values, such as the object
+// indices of a group's surfaces
+struct IndexList
+{
+  IndexList() = default;
+  IndexList(const uint32_t *data, size_t size);
+  template <typename T>
+  IndexList(const std::vector<T> &v);
+
+  bool empty() const;
+
+  const uint32_t *data{nullptr};
+  uint32_t size{0};
+};
+
+// Instance data of a GAS, InstanceSurfaceGPUData/InstanceVolumeGPUData before
+// the lists they reference are packed
+struct SurfaceLeaf
+{
+  IndexList surfaces;
+  IndexList inputSlots;
+  IndexList slotPrims;
+  const uint32_t *primIDs{nullptr}; // device data of a split mesh chunk
+};
+
+struct VolumeLeaf
+{
+  IndexList volumes;
+};
+
+// The index lists of every group in a world packed into one table, which is
+// uploaded with a single copy instead of each group owning device allocations
+// for its lists. Lists are identified by their host data, so a list shared by
+// many leaves is packed once.
+struct PackedIndexTable
+{
+  void clear();
+
+  // Append 'list' unless packed already
+  void add(IndexList list);
+
+  // Address of a packed 'list' in 'table', a device copy of 'data' -- null if
+  // the list is empty
+  template <typename T = uint32_t>
+  const T *find(IndexList list, const uint32_t *table) const;
+
+  InstanceSurfaceGPUData resolve(
+      const SurfaceLeaf &leaf, const uint32_t *table) const;
+  InstanceVolumeGPUData resolve(
+      const VolumeLeaf &leaf, const uint32_t *table) const;
+
+  std::vector<uint32_t> data;
+
+ private:
+  std::unordered_map<const uint32_t *, uint32_t> m_offsets;
+};
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+static_assert(sizeof(DeviceObjectIndex) == sizeof(uint32_t),
+    "object indices are packed as 32-bit values");
+
+inline IndexList::IndexList(const uint32_t *d, size_t s)
+    : data(d), size(uint32_t(s))
+{}
+
+template <typename T>
+inline IndexList::IndexList(const std::vector<T> &v)
+    : IndexList((const uint32_t *)v.data(), v.size())
+{
+  static_assert(sizeof(T) == sizeof(uint32_t));
+}
+
+inline bool IndexList::empty() const
+{
+  return size == 0 || !data;
+}
+
+inline void PackedIndexTable::clear()
+{
+  data.clear();
+  m_offsets.clear();
+}
+
+inline void PackedIndexTable::add(IndexList list)
+{
+  if (list.empty() || m_offsets.count(list.data) != 0)
+    return;
+  m_offsets[list.data] = uint32_t(data.size());
+  data.insert(data.end(), list.data, list.data + list.size);
+}
+
+template <typename T>
+inline const T *PackedIndexTable::find(
+    IndexList list, const uint32_t *table) const
+{
+  if (list.empty())
+    return nullptr;
+  return (const T *)(table + m_offsets.at(list.data));
+}
+
+inline InstanceSurfaceGPUData PackedIndexTable::resolve(
+    const SurfaceLeaf &leaf, const uint32_t *table) const
+{
+  InstanceSurfaceGPUData retval;
+  retval.surfaces = find<DeviceObjectIndex>(leaf.surfaces, table);
+  retval.inputSlots = find(leaf.inputSlots, table);
+  retval.slotPrims = find(leaf.slotPrims, table);
+  retval.primIDs = leaf.primIDs;
+  return retval;
+}
+
+inline InstanceVolumeGPUData PackedIndexTable::resolve(
+    const VolumeLeaf &leaf, const uint32_t *table) const
+{
+  InstanceVolumeGPUData retval;
+  retval.volumes = find<DeviceObjectIndex>(leaf.volumes, table);
+  return retval;
+}
+
+} // namespace visrtx
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "gpu/gpu_objects.h"
+
+namespace visrtx {
+
+// Counts of the optional features found in a world, gathered by the World
+// when it (re)builds its BVHs
+struct SceneSummary
+{
+  size_t numInstances{0};
+  bool identityInstances{true}; // every instance is unmasked, identity xfm
+  int instancingDepth{0}; // levels of nested IASes below the world's TLAS
+  size_t numTriangleInstances{0};
+  size_t numVolumeInstances{0};
+  size_t numUserGeometryInstances{0};
+  size_t numNonOpaqueSurfaces{0};
+  size_t numLights{0};
+};
+
+// A material is statically opaque if its opacity is a constant which the
+// renderers treat as fully opaque -- anything else needs any-hit evaluation
+inline bool materialIsOpaque(const MaterialGPUData &md)
+{
+  return !isVarying(md, MATERIAL_PARAMETER_OPACITY)
+      && md.values.opacity >= 0.99f;
+}
+
+// OptiX geometry flags for a surface's build input: any-hit programs (which
+// evaluate material opacity) only need to run on surfaces which may be
+// transparent
+inline uint32_t surfaceGeometryFlags(bool materialIsOpaque)
+{
+  return materialIsOpaque ? OPTIX_GEOMETRY_FLAG_DISABLE_ANYHIT
+                          : OPTIX_GEOMETRY_FLAG_NONE;
+}
+
+inline uint32_t deriveSceneFeatures(const SceneSummary &s)
+{
+  uint32_t features = 0;
+  if (s.numVolumeInstances > 0)
+    features |= SCENE_FEATURE_VOLUMES;
+  if (s.numNonOpaqueSurfaces > 0)
+    features |= SCENE_FEATURE_NON_OPAQUE;
+  if (s.numUserGeometryInstances > 0)
+    features |= SCENE_FEATURE_USER_GEOMETRY;
+  if (s.numLights == 1)
+    features |= SCENE_FEATURE_LIGHTS_ONE;
+  else if (s.numLights > 1)
+    features |= SCENE_FEATURE_LIGHTS_MANY;
+  if (s.instancingDepth > 0)
+    features |= SCENE_FEATURE_NESTED_INSTANCING;
+  // triangles and user geometry live in separate GASes, needing an IAS
+  else if (s.numInstances == 1 && s.identityInstances
+      && !(s.numTriangleInstances > 0 && s.numUserGeometryInstances > 0))
+    features |= SCENE_FEATURE_SINGLE_GAS;
+  return features;
+}
+
+} // namespace visrtx
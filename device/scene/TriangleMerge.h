@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "gpu/gpu_math.h"
+// std
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace visrtx {
+
+// Surfaces with at most this many triangles are merged with each other
+constexpr size_t MAX_MERGED_SURFACE_TRIANGLES = 1024;
+// Merged build inputs are split before exceeding this many triangles
+constexpr size_t MAX_MERGED_INPUT_TRIANGLES = size_t(1) << 20;
+
+// Host view of a triangle geometry's positions
+struct TriangleMesh
+{
+  uvec3 triangle(size_t i) const;
+
+  const vec3 *vertices{nullptr};
+  size_t numVertices{0};
+  const uvec3 *indices{nullptr}; // if null, every 3 vertices are a triangle
+  size_t numTriangles{0};
+  const u16vec3 *shortIndices{nullptr}; // used instead of 'indices' if set
+};
+
+// Build inputs of a GAS over a group's triangle surfaces, where small surfaces
+// with equal geometry flags share (merged) build inputs. Surfaces are addressed
+// by slot: build input i holds slots [inputSlots[i], inputSlots[i + 1]) and
+// slot s starts at primitive slotPrims[s] of its build input, which is how hits
+// are mapped back to surfaces on the device (see findSurfaceSlot()).
+struct TriangleMergePlan
+{
+  size_t numInputs() const;
+  size_t numSlots() const;
+  bool inputIsMerged(size_t input) const;
+  bool hasMerges() const;
+
+  std::vector<uint32_t> slotSurfaces; // surface index of each slot
+  std::vector<uint32_t> slotPrims;
+  std::vector<uint32_t> inputSlots{0};
+};
+
+// Plan the build inputs for surfaces with the given triangle counts and
+// geometry flags, only merging those marked 'mergeable'. Unmerged surfaces
+// come first, in order, followed by the merged inputs.
+TriangleMergePlan planTriangleMerge(const std::vector<size_t> &numTriangles,
+    const std::vector<uint32_t> &flags,
+    const std::vector<bool> &mergeable,
+    size_t maxSurfaceTriangles = MAX_MERGED_SURFACE_TRIANGLES,
+    size_t maxInputTriangles = MAX_MERGED_INPUT_TRIANGLES);
+
+// Indexed triangle mesh concatenated from several meshes, in append order
+struct MergedTriangles
+{
+  void append(const TriangleMesh &mesh);
+
+  std::vector<vec3> vertices;
+  std::vector<uvec3> indices;
+};
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+inline uvec3 TriangleMesh::triangle(size_t i) const
+{
+  if (shortIndices)
+    return uvec3(shortIndices[i]);
+  else if (indices)
+    return indices[i];
+  else
+    return uvec3(3 * i) + uvec3(0, 1, 2);
+}
+
+inline size_t TriangleMergePlan::numInputs() const
+{
+  return inputSlots.size() - 1;
+}
+
+inline size_t TriangleMergePlan::numSlots() const
+{
+  return slotSurfaces.size();
+}
+
+inline bool TriangleMergePlan::inputIsMerged(size_t input) const
+{
+  return inputSlots[input + 1] - inputSlots[input] > 1;
+}
+
+inline bool TriangleMergePlan::hasMerges() const
+{
+  return numSlots() != numInputs();
+}
+
+inline TriangleMergePlan planTriangleMerge(
+    const std::vector<size_t> &numTriangles,
+    const std::vector<uint32_t> &flags,
+    const std::vector<bool> &mergeable,
+    size_t maxSurfaceTriangles,
+    size_t maxInputTriangles)
+{
+  TriangleMergePlan plan;
+
+  auto addSlot = [&](uint32_t surface, uint32_t firstPrim) {
+    plan.slotSurfaces.push_back(surface);
+    plan.slotPrims.push_back(firstPrim);
+  };
+  auto endInput = [&]() {
+    plan.inputSlots.push_back(uint32_t(plan.slotSurfaces.size()));
+  };
+
+  // merge candidates grouped by geometry flags, which are per build input
+  auto isCandidate = [&](uint32_t i) {
+    return mergeable[i] && numTriangles[i] > 0
+        && numTriangles[i] <= maxSurfaceTriangles;
+  };
+
+  std::map<uint32_t, std::vector<uint32_t>> candidates;
+  for (uint32_t i = 0; i < numTriangles.size(); i++) {
+    if (isCandidate(i))
+      candidates[flags[i]].push_back(i);
+  }
+
+  // a single candidate with given flags has nothing to merge with
+  for (auto c = candidates.begin(); c != candidates.end();) {
+    if (c->second.size() < 2)
+      c = candidates.erase(c);
+    else
+      ++c;
+  }
+
+  auto isMerged = [&](uint32_t i) {
+    return isCandidate(i) && candidates.count(flags[i]) != 0;
+  };
+
+  for (uint32_t i = 0; i < numTriangles.size(); i++) {
+    if (!isMerged(i)) {
+      addSlot(i, 0);
+      endInput();
+    }
+  }
+
+  for (auto &c : candidates) {
+    size_t inputTriangles = 0;
+    for (auto i : c.second) {
+      if (inputTriangles > 0
+          && inputTriangles + numTriangles[i] > maxInputTriangles) {
+        endInput();
+        inputTriangles = 0;
+      }
+      addSlot(i, uint32_t(inputTriangles));
+      inputTriangles += numTriangles[i];
+    }
+    endInput();
+  }
+
+  return plan;
+}
+
+inline void MergedTriangles::append(const TriangleMesh &mesh)
+{
+  const auto base = uint32_t(vertices.size());
+  vertices.insert(
+      vertices.end(), mesh.vertices, mesh.vertices + mesh.numVertices);
+
+  for (size_t i = 0; i < mesh.numTriangles; i++) {
+    indices.push_back(mesh.triangle(i) + base);
+  }
+}
+
+} // namespace visrtx
@@ -30,6 +30,10 @@
  */
 
 #include "World.h"
+#include "SceneFeatures.h"
+// std
+#include <functional>
+#include <set>
 // ptx
 #include "Intersectors_ptx.h"
 
@@ -40,27 +44,6 @@ ptx_ptr intersection_ptx()
   return Intersectors_ptx;
 }
 
-// Helper functions ///////////////////////////////////////////////////////////
-
-static std::vector<OptixBuildInput> createOBI(
-    HostDeviceArray<OptixInstance> &optixInstances)
-{
-  auto optixInstancesDevice = optixInstances.deviceSpan();
-  auto numInstances = optixInstancesDevice.size();
-
-  if (numInstances == 0)
-    return {};
-
-  OptixBuildInput buildInput{};
-
-  buildInput.type = OPTIX_BUILD_INPUT_TYPE_INSTANCES;
-  buildInput.instanceArray.instances =
-      numInstances > 0 ? (CUdeviceptr)optixInstancesDevice.data() : 0;
-  buildInput.instanceArray.numInstances = numInstances;
-
-  return {buildInput};
-}
-
 // World definitions //////////////////////////////////////////////////////////
 
 static size_t s_numWorlds = 0;
@@ -160,6 +143,7 @@ void World::commit()
 
   m_objectUpdates.lastTLASBuild = 0;
   m_objectUpdates.lastBLASCheck = 0;
+  m_objectUpdates.lastFeatureCheck = 0;
 }
 
 OptixTraversableHandle World::optixTraversableHandleSurfaces() const
@@ -187,6 +171,11 @@ anari::Span<const InstanceLightGPUData> World::instanceLightGPUData() const
   return m_instanceLightGPUData.deviceSpan();
 }
 
+uint32_t World::sceneFeatures() const
+{
+  return m_sceneFeatures;
+}
+
 void World::rebuildBVHs()
 {
   const auto &state = *deviceState();
@@ -196,8 +185,16 @@ void World::rebuildBVHs()
     rebuildBLASs();
   }
 
-  if (state.objectUpdates.lastTLASChange < m_objectUpdates.lastTLASBuild)
+  // material changes can alter the features without touching any BVH
+  if (state.objectUpdates.lastCommitFlush >= m_objectUpdates.lastFeatureCheck)
+    updateSceneFeatures();
+
+  if (state.objectUpdates.lastTLASChange < m_objectUpdates.lastTLASBuild) {
+    if (state.objectUpdates.lastVisibilityChange
+        >= m_objectUpdates.lastVisibilityUpdate)
+      updateVisibilityMasks();
     return;
+  }
 
   m_surfaceBounds = box3();
   m_volumeBounds = box3();
@@ -205,163 +202,256 @@ void World::rebuildBVHs()
   m_traversableVolumes = {};
 
   populateOptixInstances();
-  reportMessage(ANARI_SEVERITY_DEBUG,
-      "visrtx::World building surface BVH over %zu instances",
-      m_optixSurfaceInstances.size());
-  buildOptixBVH(createOBI(m_optixSurfaceInstances),
-      m_bvhSurfaces,
-      m_traversableSurfaces,
-      m_surfaceBounds,
-      this);
+
+  if (m_sceneFeatures & SCENE_FEATURE_SINGLE_GAS)
+    useSingleGAS();
+  else {
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "visrtx::World building surface BVH over %zu instances",
+        m_optixSurfaceInstances.size());
+    buildOptixBVH(instanceBuildInput(m_optixSurfaceInstances),
+        m_bvhSurfaces,
+        m_traversableSurfaces,
+        m_surfaceBounds,
+        this,
+        true);
+
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "visrtx::World building volume BVH over %zu instances",
+        m_optixVolumeInstances.size());
+    buildOptixBVH(instanceBuildInput(m_optixVolumeInstances),
+        m_bvhVolumes,
+        m_traversableVolumes,
+        m_volumeBounds,
+        this,
+        true);
+  }
+
+  packIndexTable();
+
   reportMessage(
       ANARI_SEVERITY_DEBUG, "visrtx::World building surface gpu data");
   buildInstanceSurfaceGPUData();
 
-  reportMessage(ANARI_SEVERITY_DEBUG,
-      "visrtx::World building volume BVH over %zu instances",
-      m_optixVolumeInstances.size());
-  buildOptixBVH(createOBI(m_optixVolumeInstances),
-      m_bvhVolumes,
-      m_traversableVolumes,
-      m_volumeBounds,
-      this);
   reportMessage(ANARI_SEVERITY_DEBUG, "visrtx::World building volume gpu data");
   buildInstanceVolumeGPUData();
 
   buildInstanceLightGPUData();
 
   m_objectUpdates.lastTLASBuild = newTimeStamp();
+  m_objectUpdates.lastVisibilityUpdate = newTimeStamp();
 }
 
-void World::populateOptixInstances()
+void World::updateSceneFeatures()
 {
-  m_numTriangleInstances = 0;
-  m_numUserInstances = 0;
-  m_numVolumeInstances = 0;
-  m_numLightInstances = 0;
+  SceneSummary summary;
 
   std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
     auto *group = inst->group();
+    summary.numInstances += inst->numTransforms();
+    // a hidden or masked instance needs an OptixInstance to carry its mask
+    summary.identityInstances &=
+        inst->xfmIsIdentity() && inst->visibilityMask() == 0xFF;
     if (group->containsTriangleGeometry())
-      m_numTriangleInstances++;
-    if (group->containsUserGeometry())
-      m_numUserInstances++;
+      summary.numTriangleInstances++;
     if (group->containsVolumes())
-      m_numVolumeInstances++;
-    if (group->containsLights())
-      m_numLightInstances++;
+      summary.numVolumeInstances++;
+    if (group->containsUserGeometry())
+      summary.numUserGeometryInstances++;
+    summary.numNonOpaqueSurfaces += group->numNonOpaqueSurfaces();
+    summary.numLights += group->numLights();
+    summary.instancingDepth =
+        std::max(summary.instancingDepth, group->instancingDepth());
   });
 
-  m_optixSurfaceInstances.resize(m_numTriangleInstances + m_numUserInstances);
-  m_optixVolumeInstances.resize(m_numVolumeInstances);
+  // nested groups, each visited once no matter how often it is instanced
+  std::set<const Group *> visited;
+  std::function<void(const Group *)> summarizeNested = [&](const Group *g) {
+    for (auto *inst : g->instances()) {
+      const auto *group = inst ? inst->group() : nullptr;
+      if (!group || !visited.insert(group).second)
+        continue;
+      if (group->containsVolumes())
+        summary.numVolumeInstances++;
+      if (group->containsUserGeometry())
+        summary.numUserGeometryInstances++;
+      summary.numNonOpaqueSurfaces += group->numNonOpaqueSurfaces();
+      summarizeNested(group);
+    }
+  };
+  std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
+    summarizeNested(inst->group());
+  });
 
-  auto prepInstance = [](auto &i, int instID, auto handle) -> OptixInstance {
-    OptixInstance inst{};
+  const uint32_t features = deriveSceneFeatures(summary);
+  if (features != m_sceneFeatures) {
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "visrtx::World scene features changed (0x%x --> 0x%x)",
+        m_sceneFeatures,
+        features);
+    // frames render with the generic pipeline until these are compiled
+    deviceState()->warmUpModules(features);
+  }
 
-    mat3x4 xfm = glm::transpose(i->xfm());
-    std::memcpy(inst.transform, &xfm, sizeof(xfm));
+  // switching to/from a single GAS changes what the traversables are
+  if ((features ^ m_sceneFeatures) & SCENE_FEATURE_SINGLE_GAS)
+    m_objectUpdates.lastTLASBuild = 0;
 
-    auto *group = i->group();
-    inst.traversableHandle = handle;
-    inst.flags = OPTIX_INSTANCE_FLAG_NONE;
-    inst.instanceId = instID;
-    inst.sbtOffset = 0;
-    inst.visibilityMask = 1;
+  m_sceneFeatures = features;
+  m_objectUpdates.lastFeatureCheck = newTimeStamp();
+}
 
-    return inst;
-  };
+void World::populateOptixInstances()
+{
+  m_surfaceLeaves.clear();
+  m_volumeLeaves.clear();
+  m_snapshot.clear();
+  m_placedInstances.clear();
+  m_placedInstances.reserve(m_instances.size());
 
-  int instID = 0;
-  int instVolID = 0;
   std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
     auto *group = inst->group();
-    auto *osi = m_optixSurfaceInstances.dataHost();
-    auto *ovi = m_optixVolumeInstances.dataHost();
-    if (group->containsTriangleGeometry()) {
-      osi[instID] =
-          prepInstance(inst, instID, group->optixTraversableTriangle());
-      instID++;
-    }
-    if (group->containsUserGeometry()) {
-      osi[instID] = prepInstance(inst, instID, group->optixTraversableUser());
-      instID++;
-    }
-    if (group->containsVolumes()) {
-      ovi[instVolID] =
-          prepInstance(inst, instVolID, group->optixTraversableVolume());
-      instVolID++;
+    if (!group)
+      return;
+    if (group->containsLights() && !inst->xfmIsIdentity()) {
+      inst->reportMessage(
+          ANARI_SEVERITY_WARNING, "light transformations not implemented");
     }
+    inst->addToSnapshot(m_snapshot, m_surfaceLeaves, m_volumeLeaves);
+    m_placedInstances.push_back(inst);
   });
 
-  m_optixSurfaceInstances.upload();
-  m_optixVolumeInstances.upload();
+  m_snapshot.computeOffsets();
+
+  // a single GAS is traced directly, without any OptixInstance
+  if (m_sceneFeatures & SCENE_FEATURE_SINGLE_GAS) {
+    m_optixSurfaceInstances.resize(0);
+    m_optixVolumeInstances.resize(0);
+  } else {
+    uploadOptixInstances(m_snapshot,
+        m_placedInstances,
+        m_optixSurfaceInstances,
+        m_optixVolumeInstances);
+  }
+}
+
+void World::updateVisibilityMasks()
+{
+  const auto pass = newTimeStamp();
+  std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
+    if (auto *group = inst->group())
+      group->updateVisibilityMasks(pass);
+  });
+
+  // a single GAS has no OptixInstance, so it is only traced while visible
+  // (see updateSceneFeatures())
+  if (!(m_sceneFeatures & SCENE_FEATURE_SINGLE_GAS)
+      && uploadVisibilityMasks(m_snapshot,
+          m_placedInstances,
+          m_optixSurfaceInstances,
+          m_optixVolumeInstances)) {
+    reportMessage(ANARI_SEVERITY_DEBUG,
+        "visrtx::World refitting BVHs for visibility changes");
+    refitOptixBVH(instanceBuildInput(m_optixSurfaceInstances),
+        m_bvhSurfaces,
+        m_traversableSurfaces,
+        this);
+    refitOptixBVH(instanceBuildInput(m_optixVolumeInstances),
+        m_bvhVolumes,
+        m_traversableVolumes,
+        this);
+  }
+
+  m_objectUpdates.lastVisibilityUpdate = newTimeStamp();
+}
+
+void World::useSingleGAS()
+{
+  reportMessage(ANARI_SEVERITY_DEBUG,
+      "visrtx::World tracing single instance GAS directly, no TLAS built");
+
+  auto *group = m_instances[0]->group();
+
+  m_traversableSurfaces = group->containsUserGeometry()
+      ? group->optixTraversableUser()
+      : group->optixTraversableTriangle();
+  m_surfaceBounds = group->surfaceBounds();
+
+  m_traversableVolumes = group->optixTraversableVolume();
+  m_volumeBounds = group->volumeBounds();
+
+  m_bvhSurfaces.reset();
+  m_bvhVolumes.reset();
 }
 
 void World::rebuildBLASs()
 {
   reportMessage(ANARI_SEVERITY_DEBUG, "visrtx::World rebuilding BLASs");
 
+  const auto pass = newTimeStamp();
   std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
-    auto *group = inst->group();
-    group->rebuildSurfaceBVHs();
-    group->rebuildVolumeBVH();
-    group->rebuildLights();
+    inst->group()->rebuildBVHs(pass);
   });
 
   m_objectUpdates.lastBLASCheck = newTimeStamp();
 }
 
-void World::buildInstanceSurfaceGPUData()
+void World::packIndexTable()
 {
-  m_instanceSurfaceGPUData.resize(m_numTriangleInstances + m_numUserInstances);
+  m_indexTable.clear();
+  for (const auto &leaf : m_surfaceLeaves.entries) {
+    m_indexTable.add(leaf.surfaces);
+    m_indexTable.add(leaf.inputSlots);
+    m_indexTable.add(leaf.slotPrims);
+  }
+  for (const auto &leaf : m_volumeLeaves.entries)
+    m_indexTable.add(leaf.volumes);
+  for (const auto &g : m_snapshot.groups)
+    m_indexTable.add(g.lightIndices);
 
-  int instID = 0;
-  std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
-    auto *group = inst->group();
-    auto *sd = m_instanceSurfaceGPUData.dataHost();
-    if (group->containsTriangleGeometry())
-      sd[instID++] = {group->surfaceTriangleGPUIndices().data()};
-    if (group->containsUserGeometry())
-      sd[instID++] = {group->surfaceUserGPUIndices().data()};
-  });
+  reportMessage(ANARI_SEVERITY_DEBUG,
+      "visrtx::World packed %zu object indices",
+      m_indexTable.data.size());
 
+  m_indexTableDevice.upload(m_indexTable.data);
+}
+
+void World::buildInstanceSurfaceGPUData()
+{
+  // indexed by the (summed) instance IDs, see populateOptixInstances()
+  const auto *table = (const uint32_t *)m_indexTableDevice.ptr();
+  const auto &leaves = m_surfaceLeaves.entries;
+  m_instanceSurfaceGPUData.resize(leaves.size());
+  std::transform(leaves.begin(),
+      leaves.end(),
+      m_instanceSurfaceGPUData.begin(),
+      [&](const auto &leaf) { return m_indexTable.resolve(leaf, table); });
   m_instanceSurfaceGPUData.upload();
 }
 
 void World::buildInstanceVolumeGPUData()
 {
-  m_instanceVolumeGPUData.resize(m_numVolumeInstances);
-
-  int instID = 0;
-  std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
-    auto *group = inst->group();
-    auto *vd = m_instanceVolumeGPUData.dataHost();
-    if (group->containsVolumes())
-      vd[instID++] = {group->volumeGPUIndices().data()};
-  });
-
+  const auto *table = (const uint32_t *)m_indexTableDevice.ptr();
+  const auto &leaves = m_volumeLeaves.entries;
+  m_instanceVolumeGPUData.resize(leaves.size());
+  std::transform(leaves.begin(),
+      leaves.end(),
+      m_instanceVolumeGPUData.begin(),
+      [&](const auto &leaf) { return m_indexTable.resolve(leaf, table); });
   m_instanceVolumeGPUData.upload();
 }
 
 void World::buildInstanceLightGPUData()
 {
-  m_instanceLightGPUData.resize(m_numLightInstances);
-
-  int instID = 0;
-  std::for_each(m_instances.begin(), m_instances.end(), [&](auto *inst) {
-    auto *group = inst->group();
-    auto *li = m_instanceLightGPUData.dataHost();
-    if (group->containsLights()) {
-      group->rebuildLights();
-      const auto lgi = group->lightGPUIndices();
-      if (!inst->xfmIsIdentity() && lgi.size() != 0) {
-        inst->reportMessage(
-            ANARI_SEVERITY_WARNING, "light transformations not implemented");
-      }
-      li[instID++] = {lgi.data(), lgi.size()};
-    }
-  });
+  const auto *table = (const uint32_t *)m_indexTableDevice.ptr();
+  for (auto &g : m_snapshot.groups) {
+    g.lights.indices =
+        m_indexTable.find<DeviceObjectIndex>(g.lightIndices, table);
+    g.lights.numLights = g.lightIndices.size;
+  }
 
+  m_instanceLightGPUData.resize(m_snapshot.numLightInstances());
+  m_snapshot.writeLightInstances(m_instanceLightGPUData.dataHost());
   m_instanceLightGPUData.upload();
 }
 
@@ -59,11 +59,18 @@ struct World : public Object
   anari::Span<const InstanceVolumeGPUData> instanceVolumeGPUData() const;
   anari::Span<const InstanceLightGPUData> instanceLightGPUData() const;
 
+  // SceneFeatureFlags of the last rebuildBVHs()
+  uint32_t sceneFeatures() const;
+
   void rebuildBVHs();
 
  private:
+  void updateSceneFeatures();
   void populateOptixInstances();
+  void updateVisibilityMasks();
+  void useSingleGAS();
   void rebuildBLASs();
+  void packIndexTable();
   void buildInstanceSurfaceGPUData();
   void buildInstanceVolumeGPUData();
   void buildInstanceLightGPUData();
@@ -75,18 +82,25 @@ struct World : public Object
   anari::IntrusivePtr<Group> m_zeroGroup;
   anari::IntrusivePtr<Instance> m_zeroInstance;
 
-  size_t m_numTriangleInstances{0};
-  size_t m_numUserInstances{0};
-  size_t m_numVolumeInstances{0};
-  size_t m_numLightInstances{0};
+  // host snapshot of the instances the TLAS is built over
+  InstanceSnapshot m_snapshot;
+  std::vector<const Instance *> m_placedInstances;
+
+  // index lists of every placed group, referenced by the instance data
+  PackedIndexTable m_indexTable;
+  DeviceBuffer m_indexTableDevice;
 
   box3 m_surfaceBounds;
   box3 m_volumeBounds;
 
+  uint32_t m_sceneFeatures{SCENE_FEATURES_ALL};
+
   struct ObjectUpdates
   {
     TimeStamp lastTLASBuild{0};
     TimeStamp lastBLASCheck{0};
+    TimeStamp lastFeatureCheck{0};
+    TimeStamp lastVisibilityUpdate{0};
   } m_objectUpdates;
 
   // Surfaces //
@@ -95,6 +109,7 @@ struct World : public Object
   DeviceBuffer m_bvhSurfaces;
   HostDeviceArray<OptixInstance> m_optixSurfaceInstances;
 
+  InstanceLeafTable<SurfaceLeaf> m_surfaceLeaves;
   HostDeviceArray<InstanceSurfaceGPUData> m_instanceSurfaceGPUData;
 
   // Volumes //
@@ -103,6 +118,7 @@ struct World : public Object
   DeviceBuffer m_bvhVolumes;
   HostDeviceArray<OptixInstance> m_optixVolumeInstances;
 
+  InstanceLeafTable<VolumeLeaf> m_volumeLeaves;
   HostDeviceArray<InstanceVolumeGPUData> m_instanceVolumeGPUData;
 
   // Lights //
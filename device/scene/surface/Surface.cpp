@@ -30,6 +30,7 @@
  */
 
 #include "Surface.h"
+#include "scene/SceneFeatures.h"
 
 namespace visrtx {
 
@@ -68,9 +69,23 @@ OptixBuildInput Surface::buildInput() const
     return {};
   OptixBuildInput obi = {};
   m_geometry->populateBuildInput(obi);
+
+  // opaque surfaces skip any-hit evaluation of occlusion rays entirely
+  m_geometryFlags =
+      surfaceGeometryFlags(m_material && m_material->isOpaque());
+  if (obi.type == OPTIX_BUILD_INPUT_TYPE_TRIANGLES)
+    obi.triangleArray.flags = &m_geometryFlags;
+  else
+    obi.customPrimitiveArray.flags = &m_geometryFlags;
+
   return obi;
 }
 
+uint32_t Surface::geometryFlags() const
+{
+  return m_geometryFlags;
+}
+
 void Surface::markCommitted()
 {
   Object::markCommitted();
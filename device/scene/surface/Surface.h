@@ -46,6 +46,8 @@ struct Surface : public RegisteredObject<SurfaceGPUData>
   const Material *material() const;
 
   OptixBuildInput buildInput() const;
+  // OptixGeometryFlags of the last buildInput()
+  uint32_t geometryFlags() const;
 
   void markCommitted() override;
 
@@ -56,6 +58,7 @@ struct Surface : public RegisteredObject<SurfaceGPUData>
   anari::IntrusivePtr<Material> m_material;
 
   OptixBuildInput m_buildInput{};
+  mutable uint32_t m_geometryFlags{OPTIX_GEOMETRY_FLAG_NONE};
 };
 
 } // namespace visrtx
@@ -136,11 +136,18 @@ GeometryGPUData Cylinders::gpuData() const
   cylinder.radius = m_globalRadius.value_or(1.f);
   cylinder.caps = m_caps;
 
-  populateAttributePtr(m_vertexAttribute0, cylinder.vertexAttr[0]);
-  populateAttributePtr(m_vertexAttribute1, cylinder.vertexAttr[1]);
-  populateAttributePtr(m_vertexAttribute2, cylinder.vertexAttr[2]);
-  populateAttributePtr(m_vertexAttribute3, cylinder.vertexAttr[3]);
-  populateAttributePtr(m_vertexColor, cylinder.vertexAttr[4]);
+  return retval;
+}
+
+GeometryAttributeGPUData Cylinders::attributeData() const
+{
+  auto retval = Geometry::attributeData();
+
+  populateAttributePtr(m_vertexAttribute0, retval.vertexAttr[0]);
+  populateAttributePtr(m_vertexAttribute1, retval.vertexAttr[1]);
+  populateAttributePtr(m_vertexAttribute2, retval.vertexAttr[2]);
+  populateAttributePtr(m_vertexAttribute3, retval.vertexAttr[3]);
+  populateAttributePtr(m_vertexColor, retval.vertexAttr[4]);
 
   return retval;
 }
@@ -52,6 +52,7 @@ struct Cylinders : public Geometry
 
  private:
   GeometryGPUData gpuData() const override;
+  GeometryAttributeGPUData attributeData() const override;
   void cleanup();
 
   anari::IntrusivePtr<Array1D> m_index;
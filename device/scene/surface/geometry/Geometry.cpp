@@ -64,6 +64,7 @@ Geometry *Geometry::createInstance(
 
   retval->setDeviceState(d);
   retval->setRegistry(d->registry.geometries);
+  retval->m_attributeData.setRegistry(d->registry.geometryAttributes);
   return retval;
 }
 
@@ -79,15 +80,34 @@ void Geometry::commit()
   m_primID = getParamObject<Array1D>("primitive.primID");
 }
 
+bool Geometry::triangleMesh(TriangleMesh &) const
+{
+  return false;
+}
+
 void Geometry::markCommitted()
 {
   Object::markCommitted();
   deviceState()->objectUpdates.lastBLASChange = newTimeStamp();
 }
 
+void Geometry::upload()
+{
+  RegisteredObject::upload();
+  m_attributeData.upload(attributeData());
+}
+
 GeometryGPUData Geometry::gpuData() const
 {
   GeometryGPUData retval{};
+  if (hasAttributes(attributeData()))
+    retval.attributes = m_attributeData.index();
+  return retval;
+}
+
+GeometryAttributeGPUData Geometry::attributeData() const
+{
+  GeometryAttributeGPUData retval{};
 
   populateAttributePtr(m_attribute0, retval.attr[0]);
   populateAttributePtr(m_attribute1, retval.attr[1]);
@@ -32,6 +32,7 @@
 #pragma once
 
 #include "RegisteredObject.h"
+#include "scene/TriangleMerge.h"
 #include "utility/populateAttributePtr.h"
 
 namespace visrtx {
@@ -49,10 +50,21 @@ struct Geometry : public RegisteredObject<GeometryGPUData>
 
   virtual int optixGeometryType() const = 0;
 
+  // Host positions of triangle geometries which may be merged with others into
+  // shared build inputs (see TriangleMergePlan), false for other geometries
+  virtual bool triangleMesh(TriangleMesh &mesh) const;
+
   void markCommitted() override;
 
+  // Writes the attribute side table entry along with the registry entry
+  void upload() override;
+
  protected:
   virtual GeometryGPUData gpuData() const = 0;
+  // Per-primitive attributes, extended by geometries with vertex attributes
+  virtual GeometryAttributeGPUData attributeData() const;
+
+  RegisteredSideData<GeometryAttributeGPUData> m_attributeData;
 
   anari::IntrusivePtr<Array1D> m_colors;
   anari::IntrusivePtr<Array1D> m_attribute0;
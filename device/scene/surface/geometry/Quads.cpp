@@ -33,6 +33,24 @@
 
 namespace visrtx {
 
+// Helper functions ///////////////////////////////////////////////////////////
+
+// Split quads (a, b, c, d) into triangles (a, b, c) and (c, d, a), see
+// QuadGeometryData, where null 'quads' means every 4 vertices are a quad
+template <typename TRIANGLE_T, typename QUAD_T>
+static void splitQuads(const QUAD_T *quads, size_t numQuads, DeviceBuffer &out)
+{
+  std::vector<TRIANGLE_T> triangles(2 * numQuads);
+  for (size_t i = 0; i < numQuads; i++) {
+    const auto q = quads ? quads[i] : QUAD_T(4 * i) + QUAD_T(0, 1, 2, 3);
+    triangles[2 * i + 0] = TRIANGLE_T(q.x, q.y, q.z);
+    triangles[2 * i + 1] = TRIANGLE_T(q.z, q.w, q.x);
+  }
+  out.upload(triangles);
+}
+
+// Quads definitions //////////////////////////////////////////////////////////
+
 Quads::~Quads()
 {
   cleanup();
@@ -67,6 +85,15 @@ void Quads::commit()
     return;
   }
 
+  if (m_index && m_index->elementType() != ANARI_UINT32_VEC4
+      && m_index->elementType() != ANARI_UINT16_VEC4) {
+    reportMessage(ANARI_SEVERITY_ERROR,
+        "'primitive.index' on quad geometry must be of type UINT32_VEC4"
+        " or UINT16_VEC4");
+    m_index = {};
+    return;
+  }
+
   if (!m_index && m_vertex->size() % 4 != 0) {
     reportMessage(ANARI_SEVERITY_ERROR,
         "'vertex.position' on quad geometry is a non-multiple of 4"
@@ -78,7 +105,7 @@ void Quads::commit()
     m_index->addCommitObserver(this);
   m_vertex->addCommitObserver(this);
 
-  generateIndices();
+  generateTriangleIndices();
   m_vertexBufferPtr = (CUdeviceptr)m_vertex->deviceDataAs<vec3>();
 }
 
@@ -91,10 +118,14 @@ void Quads::populateBuildInput(OptixBuildInput &buildInput) const
   buildInput.triangleArray.numVertices = m_vertex->size();
   buildInput.triangleArray.vertexBuffers = &m_vertexBufferPtr;
 
-  buildInput.triangleArray.indexFormat = OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
-  buildInput.triangleArray.indexStrideInBytes = sizeof(uvec3);
-  buildInput.triangleArray.numIndexTriplets = m_indices.size();
-  buildInput.triangleArray.indexBuffer = (CUdeviceptr)m_indices.dataDevice();
+  const bool shortTriangles = shortIndices();
+  buildInput.triangleArray.indexFormat = shortTriangles
+      ? OPTIX_INDICES_FORMAT_UNSIGNED_SHORT3
+      : OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
+  buildInput.triangleArray.indexStrideInBytes =
+      shortTriangles ? sizeof(u16vec3) : sizeof(uvec3);
+  buildInput.triangleArray.numIndexTriplets = 2 * numQuads();
+  buildInput.triangleArray.indexBuffer = (CUdeviceptr)m_triangleIndices.ptr();
 
   static uint32_t buildInputFlags[1] = {0};
 
@@ -115,64 +146,69 @@ GeometryGPUData Quads::gpuData() const
   auto &quad = retval.quad;
 
   quad.vertices = m_vertex->deviceDataAs<vec3>();
-  quad.indices = m_indices.dataDevice();
+  quad.indices = m_index ? m_index->deviceData() : nullptr;
+  retval.shortIndices = shortIndices();
 
   quad.vertexNormals =
       m_vertexNormal ? m_vertexNormal->deviceDataAs<vec3>() : nullptr;
 
-  populateAttributePtr(m_vertexAttribute0, quad.vertexAttr[0]);
-  populateAttributePtr(m_vertexAttribute1, quad.vertexAttr[1]);
-  populateAttributePtr(m_vertexAttribute2, quad.vertexAttr[2]);
-  populateAttributePtr(m_vertexAttribute3, quad.vertexAttr[3]);
-
-  populateAttributePtr(m_vertexColor, quad.vertexAttr[4]);
-
   quad.vertexNormalIndices = m_vertexNormalIndex
       ? m_vertexNormalIndex->deviceDataAs<uvec3>()
       : nullptr;
 
-  quad.vertexAttrIndices[0] = m_vertexAttribute0Index
+  return retval;
+}
+
+GeometryAttributeGPUData Quads::attributeData() const
+{
+  auto retval = Geometry::attributeData();
+
+  populateAttributePtr(m_vertexAttribute0, retval.vertexAttr[0]);
+  populateAttributePtr(m_vertexAttribute1, retval.vertexAttr[1]);
+  populateAttributePtr(m_vertexAttribute2, retval.vertexAttr[2]);
+  populateAttributePtr(m_vertexAttribute3, retval.vertexAttr[3]);
+
+  populateAttributePtr(m_vertexColor, retval.vertexAttr[4]);
+
+  retval.vertexAttrIndices[0] = m_vertexAttribute0Index
       ? m_vertexAttribute0Index->deviceDataAs<uvec3>()
       : nullptr;
-  quad.vertexAttrIndices[1] = m_vertexAttribute1Index
+  retval.vertexAttrIndices[1] = m_vertexAttribute1Index
       ? m_vertexAttribute1Index->deviceDataAs<uvec3>()
       : nullptr;
-  quad.vertexAttrIndices[2] = m_vertexAttribute2Index
+  retval.vertexAttrIndices[2] = m_vertexAttribute2Index
       ? m_vertexAttribute2Index->deviceDataAs<uvec3>()
       : nullptr;
-  quad.vertexAttrIndices[3] = m_vertexAttribute3Index
+  retval.vertexAttrIndices[3] = m_vertexAttribute3Index
       ? m_vertexAttribute3Index->deviceDataAs<uvec3>()
       : nullptr;
 
-  quad.vertexAttrIndices[4] =
+  retval.vertexAttrIndices[4] =
       m_vertexColorIndex ? m_vertexColorIndex->deviceDataAs<uvec3>() : nullptr;
 
   return retval;
 }
 
-void Quads::generateIndices()
+void Quads::generateTriangleIndices()
 {
-  if (m_index) {
-    size_t numIndices = 2 * m_index->size();
-    m_indices.resize(numIndices);
-    auto *indicesIn = (const uvec4 *)m_index->hostData();
-    auto *indicesOut = m_indices.dataHost();
-    for (size_t i = 0; i < m_index->size(); i++) {
-      auto idx = indicesIn[i];
-      indicesOut[2 * i + 0] = uvec3(idx.x, idx.y, idx.z);
-      indicesOut[2 * i + 1] = uvec3(idx.z, idx.w, idx.x);
-    }
+  if (shortIndices()) {
+    splitQuads<u16vec3>(
+        (const u16vec4 *)m_index->hostData(), numQuads(), m_triangleIndices);
   } else {
-    size_t numQuads = 2 * (m_vertex->size() / 4);
-    m_indices.resize(2 * numQuads);
-    auto *indicesOut = m_indices.dataHost();
-    for (size_t i = 0; i < numQuads; i++) {
-      indicesOut[2 * i + 0] = uvec3(4 * i) + uvec3(0, 1, 2);
-      indicesOut[2 * i + 1] = uvec3(4 * i) + uvec3(2, 3, 0);
-    }
+    splitQuads<uvec3>(m_index ? (const uvec4 *)m_index->hostData() : nullptr,
+        numQuads(),
+        m_triangleIndices);
   }
+}
+
+bool Quads::shortIndices() const
+{
+  return m_index && m_index->elementType() == ANARI_UINT16_VEC4;
+}
 
-  m_indices.upload();
+size_t Quads::numQuads() const
+{
+  return m_index ? m_index->size() : m_vertex->size() / 4;
 }
 
 void Quads::cleanup()
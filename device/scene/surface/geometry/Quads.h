@@ -33,6 +33,7 @@
 
 #include "array/Array.h"
 #include "Geometry.h"
+#include "utility/DeviceBuffer.h"
 
 namespace visrtx {
 
@@ -49,12 +50,16 @@ struct Quads : public Geometry
 
  private:
   GeometryGPUData gpuData() const override;
-  void generateIndices();
+  GeometryAttributeGPUData attributeData() const override;
+  void generateTriangleIndices();
+  bool shortIndices() const;
+  size_t numQuads() const;
   void cleanup();
 
   anari::IntrusivePtr<Array1D> m_index;
 
-  HostDeviceArray<uvec3> m_indices;
+  // BVH build input only, the device reads the native quads in 'm_index'
+  DeviceBuffer m_triangleIndices;
 
   anari::IntrusivePtr<Array1D> m_vertex;
   anari::IntrusivePtr<Array1D> m_vertexColor;
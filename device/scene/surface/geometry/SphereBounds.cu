@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SphereBounds.h"
+// thrust
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace visrtx {
+
+struct SphereBoundsOp
+{
+  const vec3 *centers;
+  const float *radii;
+  float radius;
+  box3 *bounds;
+
+  __device__ void operator()(size_t i)
+  {
+    const float r = radii ? radii[i] : radius;
+    bounds[i] = box3(centers[i] - r, centers[i] + r);
+  }
+};
+
+void computeSphereBounds(cudaStream_t stream,
+    const vec3 *centers,
+    const float *radii,
+    float radius,
+    size_t numSpheres,
+    box3 *bounds)
+{
+  if (numSpheres == 0)
+    return;
+
+  SphereBoundsOp op;
+  op.centers = centers;
+  op.radii = radii;
+  op.radius = radius;
+  op.bounds = bounds;
+  thrust::for_each(thrust::cuda::par.on(stream),
+      thrust::make_counting_iterator(size_t(0)),
+      thrust::make_counting_iterator(numSpheres),
+      op);
+}
+
+} // namespace visrtx
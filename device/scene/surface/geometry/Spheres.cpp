@@ -30,6 +30,7 @@
  */
 
 #include "Spheres.h"
+#include "SphereBounds.h"
 
 namespace visrtx {
 
@@ -70,25 +71,15 @@ void Spheres::commit()
 
   // Calculate bounds //
 
-  m_aabbs.resize(m_vertex->size());
-
-  {
-    auto *begin = m_vertex->hostDataAs<vec3>();
-    auto *end = begin + m_vertex->size();
-
-    float *radius = nullptr;
-    if (m_radius)
-      radius = m_radius->hostDataAs<float>();
-
-    size_t sphereID = 0;
-    std::transform(begin, end, m_aabbs.begin(), [&](const vec3 &v) {
-      const float r = radius ? radius[sphereID++] : globalRadius;
-      return box3(v - r, v + r);
-    });
-  }
-
-  m_aabbs.upload();
-  m_aabbsBufferPtr = (CUdeviceptr)m_aabbs.dataDevice();
+  // on the device, so device resident arrays never need to be downloaded
+  m_aabbs.reserve(m_vertex->size() * sizeof(box3));
+  computeSphereBounds(deviceState()->stream,
+      m_vertex->deviceDataAs<vec3>(),
+      m_radius ? m_radius->deviceDataAs<float>() : nullptr,
+      globalRadius,
+      m_vertex->size(),
+      (box3 *)m_aabbs.ptr());
+  m_aabbsBufferPtr = (CUdeviceptr)m_aabbs.ptr();
 }
 
 void Spheres::populateBuildInput(OptixBuildInput &buildInput) const
@@ -96,7 +87,7 @@ void Spheres::populateBuildInput(OptixBuildInput &buildInput) const
   buildInput.type = OPTIX_BUILD_INPUT_TYPE_CUSTOM_PRIMITIVES;
 
   buildInput.customPrimitiveArray.aabbBuffers = &m_aabbsBufferPtr;
-  buildInput.customPrimitiveArray.numPrimitives = m_aabbs.size();
+  buildInput.customPrimitiveArray.numPrimitives = m_vertex->size();
 
   static uint32_t buildInputFlags[1] = {OPTIX_GEOMETRY_FLAG_NONE};
 
@@ -117,11 +108,18 @@ GeometryGPUData Spheres::gpuData() const
     sphere.radii = m_radius->deviceDataAs<float>();
   sphere.radius = m_globalRadius.value_or(0.01f);
 
-  populateAttributePtr(m_vertexAttribute0, sphere.vertexAttr[0]);
-  populateAttributePtr(m_vertexAttribute1, sphere.vertexAttr[1]);
-  populateAttributePtr(m_vertexAttribute2, sphere.vertexAttr[2]);
-  populateAttributePtr(m_vertexAttribute3, sphere.vertexAttr[3]);
-  populateAttributePtr(m_vertexColor, sphere.vertexAttr[4]);
+  return retval;
+}
+
+GeometryAttributeGPUData Spheres::attributeData() const
+{
+  auto retval = Geometry::attributeData();
+
+  populateAttributePtr(m_vertexAttribute0, retval.vertexAttr[0]);
+  populateAttributePtr(m_vertexAttribute1, retval.vertexAttr[1]);
+  populateAttributePtr(m_vertexAttribute2, retval.vertexAttr[2]);
+  populateAttributePtr(m_vertexAttribute3, retval.vertexAttr[3]);
+  populateAttributePtr(m_vertexColor, retval.vertexAttr[4]);
 
   return retval;
 }
@@ -33,7 +33,7 @@
 
 #include "array/Array.h"
 #include "Geometry.h"
-#include "utility/HostDeviceArray.h"
+#include "utility/DeviceBuffer.h"
 
 #include "anari/detail/Optional.h"
 
@@ -52,6 +52,7 @@ struct Spheres : public Geometry
 
  private:
   GeometryGPUData gpuData() const override;
+  GeometryAttributeGPUData attributeData() const override;
   void cleanup();
 
   anari::IntrusivePtr<Array1D> m_radius;
@@ -63,7 +64,7 @@ struct Spheres : public Geometry
   anari::IntrusivePtr<Array1D> m_vertexAttribute2;
   anari::IntrusivePtr<Array1D> m_vertexAttribute3;
 
-  HostDeviceArray<box3> m_aabbs;
+  DeviceBuffer m_aabbs;
   CUdeviceptr m_aabbsBufferPtr{};
 
   anari::Optional<float> m_globalRadius;
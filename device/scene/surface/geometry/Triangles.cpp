@@ -67,6 +67,15 @@ void Triangles::commit()
     return;
   }
 
+  if (m_index && m_index->elementType() != ANARI_UINT32_VEC3
+      && m_index->elementType() != ANARI_UINT16_VEC3) {
+    reportMessage(ANARI_SEVERITY_ERROR,
+        "'primitive.index' on triangle geometry must be of type UINT32_VEC3"
+        " or UINT16_VEC3");
+    m_index = {};
+    return;
+  }
+
   if (!m_index && m_vertex->size() % 3 != 0) {
     reportMessage(ANARI_SEVERITY_ERROR,
         "'vertex.position' on triangle geometry is a non-multiple of 3"
@@ -100,11 +109,15 @@ void Triangles::populateBuildInput(OptixBuildInput &buildInput) const
   buildInput.triangleArray.vertexBuffers = &m_vertexBufferPtr;
 
   if (m_index) {
-    buildInput.triangleArray.indexFormat = OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
-    buildInput.triangleArray.indexStrideInBytes = sizeof(uvec3);
+    // 16-bit indices are passed to OptiX as is
+    const bool shortIndices = m_index->elementType() == ANARI_UINT16_VEC3;
+    buildInput.triangleArray.indexFormat = shortIndices
+        ? OPTIX_INDICES_FORMAT_UNSIGNED_SHORT3
+        : OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
+    buildInput.triangleArray.indexStrideInBytes =
+        shortIndices ? sizeof(u16vec3) : sizeof(uvec3);
     buildInput.triangleArray.numIndexTriplets = m_index->size();
-    buildInput.triangleArray.indexBuffer =
-        (CUdeviceptr)m_index->deviceDataAs<uvec3>();
+    buildInput.triangleArray.indexBuffer = (CUdeviceptr)m_index->deviceData();
   } else {
     buildInput.triangleArray.indexFormat = OPTIX_INDICES_FORMAT_NONE;
     buildInput.triangleArray.indexStrideInBytes = 0;
@@ -123,6 +136,25 @@ int Triangles::optixGeometryType() const
   return OPTIX_BUILD_INPUT_TYPE_TRIANGLES;
 }
 
+bool Triangles::triangleMesh(TriangleMesh &mesh) const
+{
+  // device resident meshes are built as they are instead of being downloaded
+  if (!m_vertex || m_vertex->isDeviceResident()
+      || (m_index && m_index->isDeviceResident()) || !m_vertex->hostData())
+    return false;
+
+  mesh.vertices = m_vertex->hostDataAs<vec3>();
+  mesh.numVertices = m_vertex->size();
+  mesh.numTriangles = m_index ? m_index->size() : m_vertex->size() / 3;
+  if (!m_index)
+    return true;
+  else if (m_index->elementType() == ANARI_UINT16_VEC3)
+    mesh.shortIndices = (const u16vec3 *)m_index->hostData();
+  else
+    mesh.indices = (const uvec3 *)m_index->hostData();
+  return mesh.indices || mesh.shortIndices;
+}
+
 GeometryGPUData Triangles::gpuData() const
 {
   auto retval = Geometry::gpuData();
@@ -131,36 +163,44 @@ GeometryGPUData Triangles::gpuData() const
   auto &tri = retval.tri;
 
   tri.vertices = m_vertex->deviceDataAs<vec3>();
-  tri.indices = m_index ? m_index->deviceDataAs<uvec3>() : nullptr;
+  tri.indices = m_index ? m_index->deviceData() : nullptr;
+  retval.shortIndices = m_index && m_index->elementType() == ANARI_UINT16_VEC3;
 
   tri.vertexNormals =
       m_vertexNormal ? m_vertexNormal->deviceDataAs<vec3>() : nullptr;
 
-  populateAttributePtr(m_vertexAttribute0, tri.vertexAttr[0]);
-  populateAttributePtr(m_vertexAttribute1, tri.vertexAttr[1]);
-  populateAttributePtr(m_vertexAttribute2, tri.vertexAttr[2]);
-  populateAttributePtr(m_vertexAttribute3, tri.vertexAttr[3]);
-
-  populateAttributePtr(m_vertexColor, tri.vertexAttr[4]);
-
   tri.vertexNormalIndices = m_vertexNormalIndex
       ? m_vertexNormalIndex->deviceDataAs<uvec3>()
       : nullptr;
 
-  tri.vertexAttrIndices[0] = m_vertexAttribute0Index
+  return retval;
+}
+
+GeometryAttributeGPUData Triangles::attributeData() const
+{
+  auto retval = Geometry::attributeData();
+
+  populateAttributePtr(m_vertexAttribute0, retval.vertexAttr[0]);
+  populateAttributePtr(m_vertexAttribute1, retval.vertexAttr[1]);
+  populateAttributePtr(m_vertexAttribute2, retval.vertexAttr[2]);
+  populateAttributePtr(m_vertexAttribute3, retval.vertexAttr[3]);
+
+  populateAttributePtr(m_vertexColor, retval.vertexAttr[4]);
+
+  retval.vertexAttrIndices[0] = m_vertexAttribute0Index
       ? m_vertexAttribute0Index->deviceDataAs<uvec3>()
       : nullptr;
-  tri.vertexAttrIndices[1] = m_vertexAttribute1Index
+  retval.vertexAttrIndices[1] = m_vertexAttribute1Index
       ? m_vertexAttribute1Index->deviceDataAs<uvec3>()
       : nullptr;
-  tri.vertexAttrIndices[2] = m_vertexAttribute2Index
+  retval.vertexAttrIndices[2] = m_vertexAttribute2Index
       ? m_vertexAttribute2Index->deviceDataAs<uvec3>()
       : nullptr;
-  tri.vertexAttrIndices[3] = m_vertexAttribute3Index
+  retval.vertexAttrIndices[3] = m_vertexAttribute3Index
       ? m_vertexAttribute3Index->deviceDataAs<uvec3>()
       : nullptr;
 
-  tri.vertexAttrIndices[4] =
+  retval.vertexAttrIndices[4] =
       m_vertexColorIndex ? m_vertexColorIndex->deviceDataAs<uvec3>() : nullptr;
 
   return retval;
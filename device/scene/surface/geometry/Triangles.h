@@ -47,8 +47,11 @@ struct Triangles : public Geometry
 
   int optixGeometryType() const override;
 
+  bool triangleMesh(TriangleMesh &mesh) const override;
+
  private:
   GeometryGPUData gpuData() const override;
+  GeometryAttributeGPUData attributeData() const override;
   void cleanup();
 
   anari::IntrusivePtr<Array1D> m_index;
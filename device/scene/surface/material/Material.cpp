@@ -30,6 +30,7 @@
  */
 
 #include "Material.h"
+#include "scene/SceneFeatures.h"
 // specific types
 #include "Matte.h"
 #include "PBR.h"
@@ -59,9 +60,48 @@ Material *Material::createInstance(
 
   retval->setDeviceState(d);
   retval->setRegistry(d->registry.materials);
+  retval->m_varyingData.setRegistry(d->registry.materialVaryings);
   return retval;
 }
 
+bool Material::isOpaque() const
+{
+  return materialIsOpaque(gpuData());
+}
+
+void Material::upload()
+{
+  RegisteredObject::upload();
+
+  MaterialGPUData md;
+  MaterialVaryingGPUData mv;
+  packMaterialParameters(parameters(), md, mv);
+  if (md.varying != 0)
+    m_varyingData.upload(mv);
+}
+
+MaterialGPUData Material::gpuData() const
+{
+  MaterialGPUData retval;
+  MaterialVaryingGPUData mv;
+  packMaterialParameters(parameters(), retval, mv);
+  if (retval.varying != 0)
+    retval.varyingData = m_varyingData.index();
+  return retval;
+}
+
+void Material::markCommitted()
+{
+  Object::markCommitted();
+
+  // opacity is baked into surface BVHs as geometry flags (see Surface)
+  const bool opaque = isOpaque();
+  if (opaque != m_opaque) {
+    m_opaque = opaque;
+    deviceState()->objectUpdates.lastBLASChange = newTimeStamp();
+  }
+}
+
 } // namespace visrtx
 
 VISRTX_ANARI_TYPEFOR_DEFINITION(visrtx::Material *);
@@ -43,6 +43,24 @@ struct Material : public RegisteredObject<MaterialGPUData>
 
   static Material *createInstance(
       std::string_view subtype, DeviceGlobalState *d);
+
+  bool isOpaque() const;
+
+  void markCommitted() override;
+
+  // Writes the varying parameter side table entry along with the registry
+  // entry
+  void upload() override;
+
+ protected:
+  // Packed into the material's registry entries by gpuData() and upload()
+  virtual MaterialParameters parameters() const = 0;
+
+ private:
+  MaterialGPUData gpuData() const override;
+
+  RegisteredSideData<MaterialVaryingGPUData> m_varyingData;
+  bool m_opaque{true};
 };
 
 // Inlined helper functions ///////////////////////////////////////////////////
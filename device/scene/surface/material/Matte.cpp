@@ -40,9 +40,9 @@ void Matte::commit()
   m_colorAttribute = getParam<std::string>("color", "");
 }
 
-MaterialGPUData Matte::gpuData() const
+MaterialParameters Matte::parameters() const
 {
-  MaterialGPUData retval;
+  MaterialParameters retval;
 
   populateMaterialParameter(
       retval.baseColor, m_color, m_colorSampler, m_colorAttribute);
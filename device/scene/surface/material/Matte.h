@@ -42,7 +42,7 @@ struct Matte : public Material
   void commit() override;
 
  private:
-  MaterialGPUData gpuData() const override;
+  MaterialParameters parameters() const override;
 
   vec3 m_color{1.f};
   anari::IntrusivePtr<Sampler> m_colorSampler;
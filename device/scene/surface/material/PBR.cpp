@@ -60,9 +60,9 @@ void PBR::commit()
   m_roughnessAttribute = getParam<std::string>("roughness", "");
 }
 
-MaterialGPUData PBR::gpuData() const
+MaterialParameters PBR::parameters() const
 {
-  MaterialGPUData retval;
+  MaterialParameters retval;
 
   populateMaterialParameter(
       retval.baseColor, m_color, m_colorSampler, m_colorAttribute);
@@ -43,7 +43,7 @@ struct PBR : public Material
   void commit() override;
 
  private:
-  MaterialGPUData gpuData() const override;
+  MaterialParameters parameters() const override;
 
   bool m_separateOpacity{false};
 
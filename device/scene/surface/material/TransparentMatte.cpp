@@ -44,9 +44,9 @@ void TransparentMatte::commit()
   m_opacityAttribute = getParam<std::string>("opacity", "");
 }
 
-MaterialGPUData TransparentMatte::gpuData() const
+MaterialParameters TransparentMatte::parameters() const
 {
-  MaterialGPUData retval;
+  MaterialParameters retval;
 
   populateMaterialParameter(
       retval.baseColor, m_color, m_colorSampler, m_colorAttribute);
@@ -105,13 +105,20 @@ void StructuredRegularField::commit()
   cudaMalloc3DArray(
       &m_cudaArray, &desc, make_cudaExtent(dims.x, dims.y, dims.z));
 
+  // device resident data is copied into the texture without a host round trip
+  const bool onDevice = m_params.data->isDeviceResident();
+
   cudaMemcpy3DParms copyParams;
   std::memset(&copyParams, 0, sizeof(copyParams));
   copyParams.srcPtr = make_cudaPitchedPtr(
-      m_params.data->hostData(), dims.x * formatSize, dims.x, dims.y);
+      onDevice ? m_params.data->deviceData() : m_params.data->hostData(),
+      dims.x * formatSize,
+      dims.x,
+      dims.y);
   copyParams.dstArray = m_cudaArray;
   copyParams.extent = make_cudaExtent(dims.x, dims.y, dims.z);
-  copyParams.kind = cudaMemcpyHostToDevice;
+  copyParams.kind =
+      onDevice ? cudaMemcpyDeviceToDevice : cudaMemcpyHostToDevice;
 
   cudaMemcpy3D(&copyParams);
 
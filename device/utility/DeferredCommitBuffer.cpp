@@ -69,7 +69,10 @@ bool DeferredCommitBuffer::flush()
 
   m_needToSortCommits = false;
 
-  for (auto obj : m_commitBuffer) {
+  // commits may queue further objects (e.g. observers of a newly file mapped
+  // array), which have to be picked up in this same flush
+  for (size_t i = 0; i < m_commitBuffer.size(); i++) {
+    auto *obj = m_commitBuffer[i];
     if (obj->lastUpdated() > obj->lastCommitted()) {
       obj->commit();
       obj->upload();
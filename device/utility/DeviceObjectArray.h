@@ -33,11 +33,13 @@
 
 #include "optix_visrtx.h"
 #include "utility/HostDeviceArray.h"
-// std
-#include <stack>
+#include "utility/SlotAllocator.h"
 
 namespace visrtx {
 
+// Device copy of the GPU data of one object type, indexed by DeviceObjectIndex.
+// Storage grows geometrically and only the slots written since the last upload
+// are copied, coalesced into contiguous ranges.
 template <typename T>
 struct DeviceObjectArray
 {
@@ -59,50 +61,42 @@ struct DeviceObjectArray
   const T *devicePtr();
 
  private:
-  bool m_fullReupload{true};
   HostDeviceArray<T> m_objects;
-
-  using DOI = DeviceObjectIndex;
-  std::stack<DOI, std::vector<DOI>> m_freeIndices;
-
-  std::vector<DOI> m_objectsToUpload;
+  SlotAllocator m_slots;
 };
 
 // Inlined definitions ////////////////////////////////////////////////////////
 
+// Clean slots between dirty ones which are still uploaded with them, instead
+// of issuing a separate copy for each
+constexpr size_t DEVICE_OBJECT_UPLOAD_MAX_GAP = 16;
+
 template <typename T>
 inline DeviceObjectIndex DeviceObjectArray<T>::alloc()
 {
-  DeviceObjectIndex i = -1;
-
-  if (!m_freeIndices.empty()) {
-    i = m_freeIndices.top();
-    m_freeIndices.pop();
-  } else {
-    i = static_cast<DeviceObjectIndex>(m_objects.size());
-    m_objects.resize(m_objects.size() + 1, false);
-    m_fullReupload = true;
-  }
-
+  const auto i = static_cast<DeviceObjectIndex>(m_slots.alloc());
+  // the device storage is reallocated (and fully uploaded) on the next upload
+  if (m_slots.capacity() != m_objects.size())
+    m_objects.resize(m_slots.capacity(), false);
   return i;
 }
 
 template <typename T>
 inline void DeviceObjectArray<T>::free(DeviceObjectIndex idx)
 {
-  m_freeIndices.push(idx);
+  m_slots.free(static_cast<uint32_t>(idx));
 }
 
 template <typename T>
 inline size_t DeviceObjectArray<T>::capacity() const
 {
-  return m_objects.size();
+  return m_slots.capacity();
 }
 
 template <typename T>
 inline size_t DeviceObjectArray<T>::size() const
 {
-  return m_objects.size() - m_freeIndices.size();
+  return m_slots.size();
 }
 
 template <typename T>
@@ -120,24 +114,20 @@ inline T &DeviceObjectArray<T>::map(DeviceObjectIndex idx)
 template <typename T>
 inline void DeviceObjectArray<T>::unmap(DeviceObjectIndex idx)
 {
-  m_objectsToUpload.push_back(idx);
+  m_slots.markDirty(static_cast<uint32_t>(idx));
 }
 
 template <typename T>
 inline void DeviceObjectArray<T>::upload()
 {
-  if (m_objectsToUpload.empty())
+  if (!m_slots.hasDirtySlots())
     return;
 
-  if (m_fullReupload)
-    m_objects.upload();
-  else {
-    for (auto i : m_objectsToUpload)
-      m_objects.upload(i, i + 1);
-  }
+  if (m_slots.capacityChanged())
+    m_objects.resize(m_slots.capacity(), true);
 
-  m_objectsToUpload.clear();
-  m_fullReupload = false;
+  for (auto r : m_slots.takeDirtyRanges(DEVICE_OBJECT_UPLOAD_MAX_GAP))
+    m_objects.upload(r.first, r.second);
 }
 
 template <typename T>
@@ -147,4 +137,4 @@ inline const T *DeviceObjectArray<T>::devicePtr()
   return m_objects.dataDevice();
 }
 
-} // namespace visrtx
\ No newline at end of file
+} // namespace visrtx
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utility/MappedFile.h"
+// std
+#include <stdexcept>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+// posix
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace visrtx {
+
+// Helper functions //
+
+// Mapping offsets must be aligned to the allocation granularity on Windows and
+// to the page size elsewhere
+static size_t mappingAlignment()
+{
+#ifdef _WIN32
+  static const size_t s_alignment = []() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return size_t(info.dwAllocationGranularity);
+  }();
+#else
+  static const size_t s_alignment = size_t(sysconf(_SC_PAGESIZE));
+#endif
+  return s_alignment;
+}
+
+static std::runtime_error mappingError(
+    const char *what, const std::string &filename)
+{
+#ifdef _WIN32
+  const std::string reason = "error " + std::to_string(GetLastError());
+#else
+  const std::string reason = std::strerror(errno);
+#endif
+  return std::runtime_error(
+      std::string("unable to ") + what + " '" + filename + "': " + reason);
+}
+
+static void checkRange(const std::string &filename,
+    size_t fileBytes,
+    size_t offset,
+    size_t numBytes)
+{
+  if (offset > fileBytes || numBytes > fileBytes - offset) {
+    throw std::runtime_error("requested range exceeds size of '" + filename
+        + "' (" + std::to_string(fileBytes) + " bytes)");
+  }
+}
+
+// MappedFile definitions /////////////////////////////////////////////////////
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(
+    const std::string &filename, size_t offset, size_t numBytes)
+{
+  HANDLE file = CreateFileA(filename.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    throw mappingError("open", filename);
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    auto error = mappingError("stat", filename);
+    CloseHandle(file);
+    throw error;
+  }
+
+  const size_t fileBytes = size_t(fileSize.QuadPart);
+  try {
+    checkRange(filename, fileBytes, offset, numBytes);
+  } catch (...) {
+    CloseHandle(file);
+    throw;
+  }
+
+  m_bytes = numBytes == 0 ? fileBytes - offset : numBytes;
+  if (m_bytes == 0) {
+    CloseHandle(file);
+    return;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    auto error = mappingError("map", filename);
+    CloseHandle(file);
+    m_bytes = 0;
+    throw error;
+  }
+
+  m_alignmentOffset = offset % mappingAlignment();
+  m_mappingBytes = m_bytes + m_alignmentOffset;
+  const uint64_t viewOffset = offset - m_alignmentOffset;
+  m_mapping = MapViewOfFile(mapping,
+      FILE_MAP_READ,
+      DWORD(viewOffset >> 32),
+      DWORD(viewOffset & 0xFFFFFFFF),
+      m_mappingBytes);
+
+  // the view keeps its own references to the file and the mapping object
+  auto error = mappingError("map", filename);
+  CloseHandle(mapping);
+  CloseHandle(file);
+
+  if (m_mapping == nullptr) {
+    m_mappingBytes = 0;
+    m_alignmentOffset = 0;
+    m_bytes = 0;
+    throw error;
+  }
+}
+
+bool MappedFile::prefetch(size_t begin, size_t numBytes) const
+{
+  if (!m_mapping || begin >= m_bytes)
+    return false;
+
+  if (numBytes == 0 || numBytes > m_bytes - begin)
+    numBytes = m_bytes - begin;
+
+#if _WIN32_WINNT >= 0x0602
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = (uint8_t *)m_mapping + m_alignmentOffset + begin;
+  range.NumberOfBytes = numBytes;
+  return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+  return true; // prefetching is only a hint, pages are read on first access
+#endif
+}
+
+void MappedFile::reset()
+{
+  if (m_mapping)
+    UnmapViewOfFile(m_mapping);
+  m_mapping = nullptr;
+  m_mappingBytes = 0;
+  m_alignmentOffset = 0;
+  m_bytes = 0;
+}
+
+#else
+
+MappedFile::MappedFile(
+    const std::string &filename, size_t offset, size_t numBytes)
+{
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw mappingError("open", filename);
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    auto error = mappingError("stat", filename);
+    close(fd);
+    throw error;
+  }
+
+  const size_t fileBytes = size_t(info.st_size);
+  try {
+    checkRange(filename, fileBytes, offset, numBytes);
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+
+  m_bytes = numBytes == 0 ? fileBytes - offset : numBytes;
+  if (m_bytes == 0) {
+    close(fd);
+    return;
+  }
+
+  m_alignmentOffset = offset % mappingAlignment();
+  m_mappingBytes = m_bytes + m_alignmentOffset;
+  m_mapping = mmap(nullptr,
+      m_mappingBytes,
+      PROT_READ,
+      MAP_PRIVATE,
+      fd,
+      off_t(offset - m_alignmentOffset));
+
+  // the mapping keeps its own reference to the file
+  auto error = mappingError("map", filename);
+  close(fd);
+
+  if (m_mapping == MAP_FAILED) {
+    m_mapping = nullptr;
+    m_mappingBytes = 0;
+    m_alignmentOffset = 0;
+    m_bytes = 0;
+    throw error;
+  }
+}
+
+bool MappedFile::prefetch(size_t begin, size_t numBytes) const
+{
+  if (!m_mapping || begin >= m_bytes)
+    return false;
+
+  if (numBytes == 0 || numBytes > m_bytes - begin)
+    numBytes = m_bytes - begin;
+
+  // madvise() also wants a page aligned address
+  const size_t mappingBegin = begin + m_alignmentOffset;
+  const size_t alignedBegin = mappingBegin - mappingBegin % mappingAlignment();
+  return madvise((uint8_t *)m_mapping + alignedBegin,
+             mappingBegin + numBytes - alignedBegin,
+             MADV_WILLNEED)
+      == 0;
+}
+
+void MappedFile::reset()
+{
+  if (m_mapping)
+    munmap(m_mapping, m_mappingBytes);
+  m_mapping = nullptr;
+  m_mappingBytes = 0;
+  m_alignmentOffset = 0;
+  m_bytes = 0;
+}
+
+#endif
+
+} // namespace visrtx
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace visrtx {
+
+// Read-only mapping of a byte range of a file. The mapping is immutable for
+// its whole lifetime, so data handed out from it never needs to be copied.
+struct MappedFile
+{
+  static constexpr size_t DEFAULT_CHUNK_BYTES = size_t(64) << 20;
+
+  MappedFile() = default;
+  // Maps 'numBytes' starting at byte 'offset' of 'filename', or everything
+  // from 'offset' to the end of the file if 'numBytes' is 0. Throws
+  // std::runtime_error on failure.
+  MappedFile(const std::string &filename, size_t offset, size_t numBytes = 0);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other);
+  MappedFile &operator=(MappedFile &&other);
+
+  const uint8_t *data() const;
+  size_t size() const;
+
+  // Hint the OS to start reading the given range in the background
+  bool prefetch(size_t begin = 0, size_t numBytes = 0) const;
+
+  // Calls f(const uint8_t *chunk, size_t offset, size_t numBytes) for
+  // consecutive chunks, prefetching the next chunk before handing out the
+  // current one if requested
+  template <typename FCN>
+  size_t forEachChunk(
+      size_t chunkBytes, FCN &&f, bool prefetchNext = true) const;
+
+  void reset();
+
+  operator bool() const;
+
+ private:
+  void *m_mapping{nullptr};
+  size_t m_mappingBytes{0};
+  size_t m_alignmentOffset{0};
+  size_t m_bytes{0};
+};
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+inline MappedFile::~MappedFile()
+{
+  reset();
+}
+
+inline MappedFile::MappedFile(MappedFile &&other)
+{
+  *this = std::move(other);
+}
+
+inline MappedFile &MappedFile::operator=(MappedFile &&other)
+{
+  if (this != &other) {
+    reset();
+    std::swap(m_mapping, other.m_mapping);
+    std::swap(m_mappingBytes, other.m_mappingBytes);
+    std::swap(m_alignmentOffset, other.m_alignmentOffset);
+    std::swap(m_bytes, other.m_bytes);
+  }
+  return *this;
+}
+
+inline const uint8_t *MappedFile::data() const
+{
+  return m_mapping ? (const uint8_t *)m_mapping + m_alignmentOffset : nullptr;
+}
+
+inline size_t MappedFile::size() const
+{
+  return m_bytes;
+}
+
+template <typename FCN>
+inline size_t MappedFile::forEachChunk(
+    size_t chunkBytes, FCN &&f, bool prefetchNext) const
+{
+  if (chunkBytes == 0)
+    chunkBytes = DEFAULT_CHUNK_BYTES;
+
+  size_t numChunks = 0;
+  for (size_t offset = 0; offset < m_bytes; offset += chunkBytes) {
+    const size_t bytes = std::min(chunkBytes, m_bytes - offset);
+    if (prefetchNext)
+      prefetch(offset + bytes, chunkBytes);
+    f(data() + offset, offset, bytes);
+    numChunks++;
+  }
+
+  return numChunks;
+}
+
+inline MappedFile::operator bool() const
+{
+  return m_mapping != nullptr;
+}
+
+} // namespace visrtx
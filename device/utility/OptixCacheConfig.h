@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+// std
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+namespace visrtx {
+
+// Settings of the OptiX disk cache as given by the application through device
+// parameters, unset values fall back to environment variables.
+struct OptixCacheParameters
+{
+  std::optional<bool> enabled;
+  std::optional<std::string> location;
+  std::optional<uint64_t> maxBytes;
+};
+
+// Resolved settings to be applied to an OptixDeviceContext. An empty location
+// or a zero size keeps the OptiX default for that setting.
+struct OptixCacheConfig
+{
+  bool enabled{true};
+  std::string location;
+  uint64_t lowWaterMark{0};
+  uint64_t highWaterMark{0};
+};
+
+// Parse sizes like "1048576", "512K", "256M", or "2G" (powers of 1024),
+// rejecting signs and sizes which don't fit 64 bits
+inline std::optional<uint64_t> parseByteSize(const char *str)
+{
+  // strtoull() would accept (and wrap) negative values
+  if (!str || !std::isdigit((unsigned char)*str))
+    return {};
+
+  char *end = nullptr;
+  errno = 0;
+  const auto value = std::strtoull(str, &end, 10);
+  if (end == str || errno == ERANGE)
+    return {};
+
+  uint64_t scale = 1;
+  switch (std::toupper(*end)) {
+  case '\0':
+    break;
+  case 'K':
+    scale = 1ull << 10;
+    break;
+  case 'M':
+    scale = 1ull << 20;
+    break;
+  case 'G':
+    scale = 1ull << 30;
+    break;
+  default:
+    return {};
+  }
+
+  if (*end != '\0' && *(end + 1) != '\0')
+    return {};
+
+  if (value > UINT64_MAX / scale)
+    return {};
+
+  return value * scale;
+}
+
+// Parameters take precedence over VISRTX_OPTIX_CACHE_DIR and
+// VISRTX_OPTIX_CACHE_SIZE (passed in as 'envLocation' and 'envSize'). Setting
+// the location to "off" or "0" disables the cache, unless it is explicitly
+// enabled. When bounded, OptiX evicts the least recently used entries down to
+// half the maximum size once it is exceeded.
+inline OptixCacheConfig resolveOptixCacheConfig(
+    const OptixCacheParameters &params,
+    const char *envLocation,
+    const char *envSize)
+{
+  OptixCacheConfig config;
+
+  if (params.location)
+    config.location = *params.location;
+  else if (envLocation)
+    config.location = envLocation;
+
+  if (config.location == "off" || config.location == "0") {
+    config.enabled = false;
+    config.location.clear();
+  }
+
+  if (params.enabled)
+    config.enabled = *params.enabled;
+
+  std::optional<uint64_t> maxBytes = params.maxBytes;
+  if (!maxBytes)
+    maxBytes = parseByteSize(envSize);
+
+  if (maxBytes && *maxBytes > 0) {
+    config.highWaterMark = *maxBytes;
+    config.lowWaterMark = *maxBytes / 2;
+  }
+
+  if (!config.enabled) {
+    config.lowWaterMark = 0;
+    config.highWaterMark = 0;
+  }
+
+  return config;
+}
+
+} // namespace visrtx
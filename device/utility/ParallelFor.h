@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace visrtx {
+
+// Call 'fcn(i)' for every i in [0, numItems), split into contiguous chunks of
+// at least 'minChunkSize' items run across the available hardware threads.
+// Small ranges run serially on the calling thread. 'fcn' must be safe to call
+// concurrently for different indices.
+template <typename FCN>
+inline void parallelFor(size_t numItems, FCN &&fcn, size_t minChunkSize = 4096)
+{
+  minChunkSize = std::max<size_t>(1, minChunkSize);
+  const size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t numChunks =
+      std::min(numThreads, (numItems + minChunkSize - 1) / minChunkSize);
+
+  auto runChunk = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      fcn(i);
+  };
+
+  if (numChunks <= 1) {
+    runChunk(0, numItems);
+    return;
+  }
+
+  const size_t chunkSize = (numItems + numChunks - 1) / numChunks;
+
+  std::vector<std::future<void>> chunks;
+  for (size_t c = 1; c < numChunks; c++) {
+    const size_t begin = c * chunkSize;
+    const size_t end = std::min(numItems, begin + chunkSize);
+    chunks.push_back(std::async(std::launch::async, runChunk, begin, end));
+  }
+
+  runChunk(0, std::min(numItems, chunkSize));
+
+  for (auto &c : chunks)
+    c.get();
+}
+
+} // namespace visrtx
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+// std
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace visrtx {
+
+// Cache of objects shared by everything holding a reference to them. Entries
+// are built on the first request of their key and released with their last
+// reference, keeping an account of the memory used by live entries.
+template <typename KEY, typename T>
+struct RefCountedCache
+{
+  // Entry for 'key', first constructing it with 'build(T &entry)', which
+  // returns the number of bytes the entry holds
+  template <typename FCN>
+  std::shared_ptr<T> acquire(const KEY &key, FCN &&build);
+
+  // Number of references to the entry for 'key', 0 if there is none
+  long refCount(const KEY &key) const;
+
+  size_t numEntries() const;
+  size_t bytes() const;
+
+ private:
+  struct State
+  {
+    mutable std::mutex mutex;
+    std::map<KEY, std::weak_ptr<T>> entries;
+    size_t bytes{0};
+  };
+
+  std::shared_ptr<State> m_state{std::make_shared<State>()};
+};
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+template <typename KEY, typename T>
+template <typename FCN>
+inline std::shared_ptr<T> RefCountedCache<KEY, T>::acquire(
+    const KEY &key, FCN &&build)
+{
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+
+  auto found = m_state->entries.find(key);
+  if (found != m_state->entries.end()) {
+    if (auto entry = found->second.lock())
+      return entry;
+  }
+
+  auto entry = std::make_unique<T>();
+  const size_t bytes = build(*entry);
+  m_state->bytes += bytes;
+
+  // the deleter keeps the state alive, so entries may outlive the cache
+  std::shared_ptr<T> retval(
+      entry.release(), [state = m_state, key, bytes](T *e) {
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->bytes -= bytes;
+          auto found = state->entries.find(key);
+          if (found != state->entries.end() && found->second.expired())
+            state->entries.erase(found);
+        }
+        delete e;
+      });
+
+  m_state->entries[key] = retval;
+  return retval;
+}
+
+template <typename KEY, typename T>
+inline long RefCountedCache<KEY, T>::refCount(const KEY &key) const
+{
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  auto found = m_state->entries.find(key);
+  return found == m_state->entries.end() ? 0 : found->second.use_count();
+}
+
+template <typename KEY, typename T>
+inline size_t RefCountedCache<KEY, T>::numEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->entries.size();
+}
+
+template <typename KEY, typename T>
+inline size_t RefCountedCache<KEY, T>::bytes() const
+{
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->bytes;
+}
+
+} // namespace visrtx
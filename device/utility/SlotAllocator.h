@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace visrtx {
+
+// Slots of an array which grows geometrically, reusing freed slots before
+// growing. Writes to slots are tracked so only the dirty parts of a copy of
+// the array (e.g. on the device) need to be updated, as contiguous ranges.
+struct SlotAllocator
+{
+  using Range = std::pair<size_t, size_t>; // [first, second)
+
+  // Index of a free slot, growing the array if none is free. Check
+  // 'capacityChanged()' for whether the storage needs to grow.
+  uint32_t alloc();
+  void free(uint32_t slot);
+
+  size_t size() const; // slots handed out and not freed
+  size_t numSlots() const; // highest slot ever handed out + 1
+  size_t capacity() const;
+
+  // Whether capacity grew since the last takeDirtyRanges(), i.e. the copy of
+  // the array needs to be reallocated and fully updated
+  bool capacityChanged() const;
+
+  void markDirty(uint32_t slot);
+  bool hasDirtySlots() const;
+
+  // Ranges of dirty slots in ascending order, clearing them. Ranges separated
+  // by at most 'maxGap' clean slots are merged, trading a few extra slots for
+  // fewer copies. After capacity changed it is the single range of all slots.
+  std::vector<Range> takeDirtyRanges(size_t maxGap = 0);
+
+ private:
+  size_t m_numSlots{0};
+  size_t m_capacity{0};
+  bool m_capacityChanged{false};
+  std::vector<uint32_t> m_freeSlots;
+  std::vector<uint32_t> m_dirtySlots;
+};
+
+// Inlined definitions ////////////////////////////////////////////////////////
+
+inline uint32_t SlotAllocator::alloc()
+{
+  if (!m_freeSlots.empty()) {
+    const auto slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return slot;
+  }
+
+  if (m_numSlots == m_capacity) {
+    m_capacity = std::max<size_t>(16, 2 * m_capacity);
+    m_capacityChanged = true;
+  }
+
+  return uint32_t(m_numSlots++);
+}
+
+inline void SlotAllocator::free(uint32_t slot)
+{
+  m_freeSlots.push_back(slot);
+}
+
+inline size_t SlotAllocator::size() const
+{
+  return m_numSlots - m_freeSlots.size();
+}
+
+inline size_t SlotAllocator::numSlots() const
+{
+  return m_numSlots;
+}
+
+inline size_t SlotAllocator::capacity() const
+{
+  return m_capacity;
+}
+
+inline bool SlotAllocator::capacityChanged() const
+{
+  return m_capacityChanged;
+}
+
+inline void SlotAllocator::markDirty(uint32_t slot)
+{
+  m_dirtySlots.push_back(slot);
+}
+
+inline bool SlotAllocator::hasDirtySlots() const
+{
+  return !m_dirtySlots.empty() || m_capacityChanged;
+}
+
+inline std::vector<SlotAllocator::Range> SlotAllocator::takeDirtyRanges(
+    size_t maxGap)
+{
+  std::vector<Range> ranges;
+
+  if (m_capacityChanged) {
+    if (m_numSlots > 0)
+      ranges.emplace_back(0, m_numSlots);
+  } else {
+    std::sort(m_dirtySlots.begin(), m_dirtySlots.end());
+    for (size_t slot : m_dirtySlots) {
+      if (!ranges.empty() && slot <= ranges.back().second + maxGap)
+        ranges.back().second = std::max(ranges.back().second, slot + 1);
+      else
+        ranges.emplace_back(slot, slot + 1);
+    }
+  }
+
+  m_dirtySlots.clear();
+  m_capacityChanged = false;
+  return ranges;
+}
+
+} // namespace visrtx
@@ -40,6 +40,7 @@ inline void populateAttributePtr(
     anari::IntrusivePtr<Array1D> array, AttributePtr &aptr)
 {
   aptr.numChannels = 0;
+  aptr.format = AttributeFormat::FLOAT32;
   aptr.data = nullptr;
 
   if (!array)
@@ -49,21 +50,56 @@ inline void populateAttributePtr(
 
   switch (type) {
   case ANARI_FLOAT32:
+  case ANARI_FLOAT16:
+  case ANARI_UFIXED8:
+  case ANARI_UFIXED16:
     aptr.numChannels = 1;
     break;
   case ANARI_FLOAT32_VEC2:
+  case ANARI_FLOAT16_VEC2:
+  case ANARI_UFIXED8_VEC2:
+  case ANARI_UFIXED16_VEC2:
     aptr.numChannels = 2;
     break;
   case ANARI_FLOAT32_VEC3:
+  case ANARI_FLOAT16_VEC3:
+  case ANARI_UFIXED8_VEC3:
+  case ANARI_UFIXED16_VEC3:
     aptr.numChannels = 3;
     break;
   case ANARI_FLOAT32_VEC4:
+  case ANARI_FLOAT16_VEC4:
+  case ANARI_UFIXED8_VEC4:
+  case ANARI_UFIXED16_VEC4:
     aptr.numChannels = 4;
     break;
   default:
     return;
   }
 
+  switch (type) {
+  case ANARI_FLOAT16:
+  case ANARI_FLOAT16_VEC2:
+  case ANARI_FLOAT16_VEC3:
+  case ANARI_FLOAT16_VEC4:
+    aptr.format = AttributeFormat::FLOAT16;
+    break;
+  case ANARI_UFIXED8:
+  case ANARI_UFIXED8_VEC2:
+  case ANARI_UFIXED8_VEC3:
+  case ANARI_UFIXED8_VEC4:
+    aptr.format = AttributeFormat::UFIXED8;
+    break;
+  case ANARI_UFIXED16:
+  case ANARI_UFIXED16_VEC2:
+  case ANARI_UFIXED16_VEC3:
+  case ANARI_UFIXED16_VEC4:
+    aptr.format = AttributeFormat::UFIXED16;
+    break;
+  default:
+    break;
+  }
+
   aptr.data = array->deviceData();
 }
 
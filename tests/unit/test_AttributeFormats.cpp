@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "gpu/getAttributeValue.h"
+// std
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace visrtx;
+
+// Straightforward reference decoders to check the device code path against
+
+static float referenceHalf(uint16_t h)
+{
+  const float sign = (h & 0x8000) ? -1.f : 1.f;
+  const int exponent = (h >> 10) & 0x1F;
+  const int mantissa = h & 0x3FF;
+  if (exponent == 0x1F) {
+    return mantissa ? std::numeric_limits<float>::quiet_NaN()
+                    : sign * std::numeric_limits<float>::infinity();
+  } else if (exponent == 0)
+    return sign * std::ldexp(float(mantissa), -24);
+  else
+    return sign * std::ldexp(float(mantissa + 1024), exponent - 25);
+}
+
+template <typename T>
+static vec4 referenceDecode(
+    const std::vector<T> &data, int numChannels, uint32_t i, float scale)
+{
+  vec4 retval(0.f, 0.f, 0.f, 1.f);
+  for (int c = 0; c < numChannels; c++)
+    retval[c] = data[i * numChannels + c] / scale;
+  return retval;
+}
+
+SCENARIO("Half precision attribute decoding", "[AttributeFormats]")
+{
+  GIVEN("Well known half precision values")
+  {
+    THEN("They decode exactly")
+    {
+      REQUIRE(halfToFloat(0x0000) == 0.f);
+      REQUIRE(halfToFloat(0x3C00) == 1.f);
+      REQUIRE(halfToFloat(0xC000) == -2.f);
+      REQUIRE(halfToFloat(0x3555) == referenceHalf(0x3555));
+      REQUIRE(halfToFloat(0x7BFF) == 65504.f);
+      REQUIRE(halfToFloat(0x0001) == std::ldexp(1.f, -24));
+      REQUIRE(std::isinf(halfToFloat(0x7C00)));
+      REQUIRE(std::isnan(halfToFloat(0x7E00)));
+    }
+  }
+
+  GIVEN("Every half precision bit pattern")
+  {
+    THEN("Decoding matches the reference decoder")
+    {
+      bool allMatch = true;
+      for (uint32_t h = 0; h <= 0xFFFF; h++) {
+        const float v = halfToFloat(uint16_t(h));
+        const float r = referenceHalf(uint16_t(h));
+        if (std::isnan(r) ? !std::isnan(v) : v != r)
+          allMatch = false;
+      }
+      REQUIRE(allMatch);
+    }
+  }
+}
+
+SCENARIO("Quantized attribute decoding", "[AttributeFormats]")
+{
+  GIVEN("An 8-bit RGBA color array")
+  {
+    std::vector<uint8_t> colors = {0, 64, 128, 255, 255, 0, 32, 16};
+    AttributePtr ap{4, AttributeFormat::UFIXED8, colors.data()};
+
+    THEN("Elements are normalized to [0, 1]")
+    {
+      for (uint32_t i = 0; i < 2; i++) {
+        const vec4 ref = referenceDecode(colors, 4, i, 255.f);
+        const vec4 v = getAttributeValue(ap, i);
+        for (int c = 0; c < 4; c++)
+          REQUIRE(v[c] == Approx(ref[c]));
+      }
+      REQUIRE(getAttributeValue(ap, 0).x == 0.f);
+      REQUIRE(getAttributeValue(ap, 0).w == 1.f);
+    }
+  }
+
+  GIVEN("A 16-bit two channel attribute array")
+  {
+    std::vector<uint16_t> values = {0, 65535, 1000, 32768, 7, 12345};
+    AttributePtr ap{2, AttributeFormat::UFIXED16, values.data()};
+
+    THEN("Elements are normalized and padded with (0, 1)")
+    {
+      for (uint32_t i = 0; i < 3; i++) {
+        const vec4 ref = referenceDecode(values, 2, i, 65535.f);
+        const vec4 v = getAttributeValue(ap, i);
+        REQUIRE(v.x == Approx(ref.x));
+        REQUIRE(v.y == Approx(ref.y));
+        REQUIRE(v.z == 0.f);
+        REQUIRE(v.w == 1.f);
+      }
+    }
+  }
+
+  GIVEN("A half precision three channel attribute array")
+  {
+    std::vector<uint16_t> values = {0x3C00, 0x3800, 0xC000, 0x0000, 0x7BFF, 1};
+    AttributePtr ap{3, AttributeFormat::FLOAT16, values.data()};
+
+    THEN("Channels are read tightly packed")
+    {
+      REQUIRE(getAttributeValue(ap, 0) == vec4(1.f, 0.5f, -2.f, 1.f));
+      REQUIRE(getAttributeValue(ap, 1)
+          == vec4(0.f, 65504.f, referenceHalf(1), 1.f));
+    }
+  }
+
+  GIVEN("A float attribute array")
+  {
+    std::vector<vec3> values = {vec3(1.f, 2.f, 3.f), vec3(4.f, 5.f, 6.f)};
+    AttributePtr ap{3, AttributeFormat::FLOAT32, values.data()};
+
+    THEN("It is read as before")
+    {
+      REQUIRE(getAttributeValue(ap, 1) == vec4(4.f, 5.f, 6.f, 1.f));
+    }
+  }
+
+  GIVEN("An invalid element index")
+  {
+    std::vector<uint8_t> colors = {255, 255, 255, 255};
+    AttributePtr ap{4, AttributeFormat::UFIXED8, colors.data()};
+
+    THEN("The default value is returned")
+    {
+      REQUIRE(getAttributeValue(ap, 0xFFFFFFFF) == vec4(0.f, 0.f, 0.f, 1.f));
+    }
+  }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "camera/CameraRecord.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("Camera record packing", "[CameraRecord]")
+{
+  GIVEN("A perspective and an orthographic camera")
+  {
+    PerspectiveCameraGPUData p{};
+    p.type = CameraType::PERSPECTIVE;
+    p.region = vec4(0.f, 0.f, 1.f, 1.f);
+    p.pos = vec3(1.f, 2.f, 3.f);
+    p.dir_00 = vec3(4.f, 5.f, 6.f);
+
+    OrthographicCameraGPUData o{};
+    o.type = CameraType::ORTHOGRAPHIC;
+    o.region = vec4(0.25f, 0.25f, 0.75f, 0.75f);
+    o.pos_00 = vec3(7.f, 8.f, 9.f);
+
+    WHEN("They are packed into an array of records")
+    {
+      std::vector<CameraRecord> records = {
+          packCameraRecord(p, sizeof(p)), packCameraRecord(o, sizeof(o))};
+
+      THEN("Records have a uniform stride that fits every camera")
+      {
+        REQUIRE(sizeof(CameraRecord) >= sizeof(PerspectiveCameraGPUData));
+        REQUIRE(sizeof(CameraRecord) >= sizeof(OrthographicCameraGPUData));
+        REQUIRE(sizeof(CameraRecord) % alignof(CameraRecord) == 0);
+        REQUIRE((uint8_t *)&records[1] - (uint8_t *)&records[0]
+            == sizeof(CameraRecord));
+      }
+
+      THEN("Each record unpacks to the original camera")
+      {
+        const auto &c0 = unpackCameraRecord(records[0]);
+        REQUIRE(c0.type == CameraType::PERSPECTIVE);
+        REQUIRE(c0.pos == p.pos);
+        REQUIRE(((const PerspectiveCameraGPUData &)c0).dir_00 == p.dir_00);
+
+        const auto &c1 = unpackCameraRecord(records[1]);
+        REQUIRE(c1.type == CameraType::ORTHOGRAPHIC);
+        REQUIRE(c1.region == o.region);
+        REQUIRE(((const OrthographicCameraGPUData &)c1).pos_00 == o.pos_00);
+      }
+    }
+
+    WHEN("A camera smaller than a record is packed")
+    {
+      CameraGPUData base{};
+      base.type = CameraType::ORTHOGRAPHIC;
+      auto record = packCameraRecord(base, sizeof(base));
+
+      THEN("The remainder of the record is zeroed")
+      {
+        for (size_t i = sizeof(base); i < sizeof(record.bytes); i++)
+          REQUIRE(record.bytes[i] == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "frame/FrameConfig.h"
+
+using namespace visrtx;
+
+SCENARIO("FrameConfig diffing", "[FrameConfig]")
+{
+  GIVEN("A committed frame config")
+  {
+    FrameConfig prev;
+    prev.size = uvec2(640, 480);
+    prev.colorType = ANARI_UFIXED8_RGBA_SRGB;
+    prev.depthBuffer = true;
+
+    THEN("An empty config differs in the buffers that were allocated")
+    {
+      auto diff = diffFrameConfigs(FrameConfig{}, prev);
+      REQUIRE(diff.colorBuffers);
+      REQUIRE(diff.depthBuffer);
+      REQUIRE(!diff.albedoBuffers);
+      REQUIRE(!diff.normalBuffer);
+      REQUIRE(!diff.normalChannelBuffers);
+      REQUIRE(!diff.denoiser);
+    }
+
+    WHEN("The same config is committed again")
+    {
+      auto diff = diffFrameConfigs(prev, prev);
+
+      THEN("Nothing changes")
+      {
+        REQUIRE(!diff.any());
+      }
+    }
+
+    WHEN("The frame is resized")
+    {
+      auto next = prev;
+      next.size = uvec2(800, 600);
+      auto diff = diffFrameConfigs(prev, next);
+
+      THEN("Only the allocated buffers are resized")
+      {
+        REQUIRE(diff.colorBuffers);
+        REQUIRE(diff.depthBuffer);
+        REQUIRE(!diff.albedoBuffers);
+        REQUIRE(!diff.normalBuffer);
+        REQUIRE(!diff.denoiser);
+      }
+    }
+
+    WHEN("The number of camera layers changes")
+    {
+      auto next = prev;
+      next.layers = 4;
+      auto diff = diffFrameConfigs(prev, next);
+
+      THEN("The allocated buffers are resized")
+      {
+        REQUIRE(diff.colorBuffers);
+        REQUIRE(diff.depthBuffer);
+        REQUIRE(!diff.albedoBuffers);
+      }
+    }
+
+    WHEN("Switching between 8-bit color formats")
+    {
+      auto next = prev;
+      next.colorType = ANARI_UFIXED8_VEC4;
+      auto diff = diffFrameConfigs(prev, next);
+
+      THEN("No buffers are reallocated")
+      {
+        REQUIRE(!diff.any());
+      }
+    }
+
+    WHEN("Switching to float color")
+    {
+      auto next = prev;
+      next.colorType = ANARI_FLOAT32_VEC4;
+      auto diff = diffFrameConfigs(prev, next);
+
+      THEN("Only the color buffers are reallocated")
+      {
+        REQUIRE(diff.colorBuffers);
+        REQUIRE(!diff.depthBuffer);
+        REQUIRE(!diff.denoiser);
+      }
+    }
+
+    WHEN("The denoiser is enabled")
+    {
+      auto next = prev;
+      next.denoise = true;
+      auto diff = diffFrameConfigs(prev, next);
+
+      THEN("The color buffers become float and the denoiser is setup")
+      {
+        REQUIRE(diff.colorBuffers);
+        REQUIRE(diff.denoiser);
+      }
+
+      AND_WHEN("Only the color format changes afterwards")
+      {
+        auto last = next;
+        last.colorType = ANARI_UFIXED8_VEC4;
+        auto diff2 = diffFrameConfigs(next, last);
+
+        THEN("The denoiser is setup again without touching buffers")
+        {
+          REQUIRE(!diff2.colorBuffers);
+          REQUIRE(diff2.denoiser);
+        }
+      }
+
+      AND_WHEN("The albedo channel is enabled afterwards")
+      {
+        auto last = next;
+        last.albedoChannel = true;
+        auto diff2 = diffFrameConfigs(next, last);
+
+        THEN("The denoiser is setup again to use it as a guide")
+        {
+          REQUIRE(diff2.albedoBuffers);
+          REQUIRE(diff2.denoiser);
+        }
+      }
+
+      AND_WHEN("The denoiser is disabled again")
+      {
+        auto diff2 = diffFrameConfigs(next, prev);
+
+        THEN("The denoiser is cleaned up")
+        {
+          REQUIRE(diff2.denoiser);
+        }
+      }
+    }
+
+    WHEN("The normal channel is enabled while normals are used as a guide")
+    {
+      auto guide = prev;
+      guide.normalBuffer = true;
+      auto next = guide;
+      next.normalChannel = true;
+      auto diff = diffFrameConfigs(guide, next);
+
+      THEN("Only the mapped normal buffers are allocated")
+      {
+        REQUIRE(!diff.normalBuffer);
+        REQUIRE(diff.normalChannelBuffers);
+        REQUIRE(!diff.colorBuffers);
+      }
+    }
+  }
+}
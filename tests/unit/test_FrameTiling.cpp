@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "frame/FrameTiling.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("Frame tile scheduling", "[FrameTiling]")
+{
+  GIVEN("A 10x7 frame split into 4x4 tiles")
+  {
+    const uvec2 frameSize(10, 7);
+    const uvec2 tileSize(4, 4);
+
+    THEN("The tile grid covers the frame")
+    {
+      REQUIRE(tileGridSize(frameSize, tileSize) == uvec2(3, 2));
+      REQUIRE(tileCount(frameSize, tileSize) == 6);
+    }
+
+    THEN("Tiles are row-major and clipped to the frame")
+    {
+      auto t0 = frameTile(frameSize, tileSize, 0);
+      REQUIRE(t0.origin == uvec2(0, 0));
+      REQUIRE(t0.size == uvec2(4, 4));
+
+      auto t2 = frameTile(frameSize, tileSize, 2);
+      REQUIRE(t2.origin == uvec2(8, 0));
+      REQUIRE(t2.size == uvec2(2, 4));
+
+      auto t5 = frameTile(frameSize, tileSize, 5);
+      REQUIRE(t5.origin == uvec2(8, 4));
+      REQUIRE(t5.size == uvec2(2, 3));
+    }
+
+    THEN("Every pixel is covered exactly once")
+    {
+      std::vector<int> coverage(frameSize.x * frameSize.y, 0);
+      for (uint32_t i = 0; i < tileCount(frameSize, tileSize); i++) {
+        auto t = frameTile(frameSize, tileSize, i);
+        for (uint32_t y = 0; y < t.size.y; y++)
+          for (uint32_t x = 0; x < t.size.x; x++)
+            coverage[(t.origin.y + y) * frameSize.x + t.origin.x + x]++;
+      }
+      for (auto c : coverage)
+        REQUIRE(c == 1);
+    }
+
+    THEN("Tile image regions are normalized frame coordinates")
+    {
+      auto tile = frameTile(frameSize, tileSize, 5);
+      auto region = tileImageRegion(frameSize, tile);
+      REQUIRE(region.x == Approx(0.8f));
+      REQUIRE(region.y == Approx(4.f / 7.f));
+      REQUIRE(region.z == Approx(1.f));
+      REQUIRE(region.w == Approx(1.f));
+    }
+  }
+}
+
+SCENARIO("Frame tile stitching", "[FrameTiling]")
+{
+  GIVEN("Tiles rendered with their pixel's frame index as the value")
+  {
+    const uvec2 frameSize(5, 3);
+    const uvec2 tileSize(2, 2);
+    std::vector<uint32_t> frame(frameSize.x * frameSize.y, ~0u);
+
+    for (uint32_t i = 0; i < tileCount(frameSize, tileSize); i++) {
+      auto t = frameTile(frameSize, tileSize, i);
+      std::vector<uint32_t> tile;
+      for (uint32_t y = 0; y < t.size.y; y++)
+        for (uint32_t x = 0; x < t.size.x; x++)
+          tile.push_back((t.origin.y + y) * frameSize.x + t.origin.x + x);
+      stitchTile(frame.data(), frameSize, tile.data(), t, sizeof(uint32_t));
+    }
+
+    THEN("The stitched frame is the identity image")
+    {
+      for (uint32_t i = 0; i < frame.size(); i++)
+        REQUIRE(frame[i] == i);
+    }
+  }
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "gpu/gpu_objects.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("Hot GPU records stay compact", "[GPURecords]")
+{
+  THEN("Geometry and material records fit their size budgets")
+  {
+    REQUIRE(sizeof(GeometryGPUData) <= 40);
+    REQUIRE(sizeof(MaterialGPUData) <= 48);
+    REQUIRE(sizeof(MaterialVaryingGPUData) <= 48);
+  }
+
+  THEN("Hot records are smaller than their cold side table entries")
+  {
+    REQUIRE(sizeof(GeometryGPUData) < sizeof(GeometryAttributeGPUData));
+  }
+}
+
+SCENARIO("Geometry attribute side table entries", "[GPURecords]")
+{
+  GIVEN("An empty attribute record")
+  {
+    GeometryAttributeGPUData ad{};
+
+    THEN("It has no attributes")
+    {
+      REQUIRE_FALSE(hasAttributes(ad));
+    }
+
+    WHEN("A vertex color array is set")
+    {
+      float colors[4] = {};
+      ad.vertexAttr[4] = {4, AttributeFormat::FLOAT32, colors};
+
+      THEN("It has attributes")
+      {
+        REQUIRE(hasAttributes(ad));
+      }
+    }
+
+    WHEN("Only primitive IDs are set")
+    {
+      uint32_t ids[1] = {7};
+      ad.primID = ids;
+
+      THEN("It has attributes")
+      {
+        REQUIRE(hasAttributes(ad));
+      }
+    }
+  }
+}
+
+SCENARIO("Geometry index decoding", "[GPURecords]")
+{
+  GIVEN("Triangles with 32-bit and 16-bit indices")
+  {
+    const std::vector<uvec3> indices = {uvec3(0, 1, 2), uvec3(70000, 3, 1)};
+    const std::vector<u16vec3> shortIndices = {
+        u16vec3(0, 1, 2), u16vec3(9, 3, 1)};
+
+    GeometryGPUData gd;
+    gd.type = GeometryType::TRIANGLE;
+
+    THEN("Both decode to the same vertex indices")
+    {
+      gd.tri.indices = indices.data();
+      REQUIRE(triangleIndices(gd, 1) == uvec3(70000, 3, 1));
+      gd.tri.indices = shortIndices.data();
+      gd.shortIndices = true;
+      REQUIRE(triangleIndices(gd, 1) == uvec3(9, 3, 1));
+    }
+
+    THEN("Unindexed triangles use consecutive vertices")
+    {
+      gd.tri.indices = nullptr;
+      REQUIRE(triangleIndices(gd, 2) == uvec3(6, 7, 8));
+    }
+  }
+
+  GIVEN("Native quads")
+  {
+    const std::vector<u16vec4> quads = {
+        u16vec4(0, 1, 2, 3), u16vec4(4, 5, 6, 7)};
+
+    GeometryGPUData gd;
+    gd.type = GeometryType::QUAD;
+    gd.quad.indices = quads.data();
+    gd.shortIndices = true;
+
+    THEN("Every quad is split into two triangles")
+    {
+      REQUIRE(quadIndices(gd, 1) == uvec4(4, 5, 6, 7));
+      REQUIRE(quadTriangleIndices(gd, 2) == uvec3(4, 5, 6));
+      REQUIRE(quadTriangleIndices(gd, 3) == uvec3(6, 7, 4));
+    }
+
+    THEN("Unindexed quads use consecutive vertices")
+    {
+      gd.quad.indices = nullptr;
+      REQUIRE(quadTriangleIndices(gd, 1) == uvec3(2, 3, 0));
+    }
+  }
+}
+
+SCENARIO("Material parameter packing", "[GPURecords]")
+{
+  MaterialGPUData md;
+  MaterialVaryingGPUData mv;
+
+  GIVEN("A material with only constant parameters")
+  {
+    MaterialParameters p;
+    p.baseColor = vec3(0.25f, 0.5f, 0.75f);
+    p.roughness = 0.3f;
+    packMaterialParameters(p, md, mv);
+
+    THEN("All values are stored inline and nothing is varying")
+    {
+      REQUIRE(md.varying == 0);
+      REQUIRE(md.varyingData == -1);
+      REQUIRE(md.values.baseColor == vec3(0.25f, 0.5f, 0.75f));
+      REQUIRE(md.values.roughness == 0.3f);
+      REQUIRE(md.values.metalness == 1.f);
+      REQUIRE(md.values.emissive == vec3(0.f));
+      REQUIRE(md.values.transmissiveness == 0.f);
+      REQUIRE(md.values.opacity == 1.f);
+    }
+  }
+
+  GIVEN("A material with a sampled color and attribute opacity")
+  {
+    MaterialParameters p;
+    p.baseColor.type = MaterialParameterType::SAMPLER;
+    p.baseColor.sampler = 3;
+    p.opacity.type = MaterialParameterType::ATTRIB_1;
+    p.metalness = 0.5f;
+    packMaterialParameters(p, md, mv);
+
+    THEN("Only those parameters are flagged as varying")
+    {
+      REQUIRE(isVarying(md, MATERIAL_PARAMETER_BASE_COLOR));
+      REQUIRE(isVarying(md, MATERIAL_PARAMETER_OPACITY));
+      REQUIRE_FALSE(isVarying(md, MATERIAL_PARAMETER_METALNESS));
+      REQUIRE_FALSE(isVarying(md, MATERIAL_PARAMETER_EMISSIVE));
+      REQUIRE_FALSE(isVarying(md, MATERIAL_PARAMETER_ROUGHNESS));
+      REQUIRE_FALSE(isVarying(md, MATERIAL_PARAMETER_TRANSMISSIVENESS));
+    }
+
+    THEN("Their sources are stored in the side table entry")
+    {
+      REQUIRE(mv.type[MATERIAL_PARAMETER_BASE_COLOR]
+          == MaterialParameterType::SAMPLER);
+      REQUIRE(mv.sampler[MATERIAL_PARAMETER_BASE_COLOR] == 3);
+      REQUIRE(mv.type[MATERIAL_PARAMETER_OPACITY]
+          == MaterialParameterType::ATTRIB_1);
+      REQUIRE(mv.sampler[MATERIAL_PARAMETER_OPACITY] == -1);
+    }
+
+    THEN("Constant parameters are still stored inline")
+    {
+      REQUIRE(md.values.metalness == 0.5f);
+    }
+
+    WHEN("The material is repacked with constants only")
+    {
+      packMaterialParameters(MaterialParameters{}, md, mv);
+
+      THEN("No parameter is left varying")
+      {
+        REQUIRE(md.varying == 0);
+      }
+    }
+  }
+}
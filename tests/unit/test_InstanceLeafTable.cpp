@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "scene/InstanceLeafTable.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("Nested instance data offsets", "[InstanceLeafTable]")
+{
+  // stand-ins for groups: a leaf group with 2 GASes and a nested group with
+  // 1 GAS of its own plus instances of the leaf group
+  const int leafGroup = 0;
+  const int nestedGroup = 0;
+
+  auto appendLeafGroup = [](std::vector<int> &e) {
+    e.push_back(10);
+    e.push_back(11);
+  };
+
+  GIVEN("A nested group's table over many instances of the leaf group")
+  {
+    InstanceLeafTable<int> nested;
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 1000; i++)
+      ids.push_back(nested.blockOffset(&leafGroup, appendLeafGroup));
+
+    THEN("Every instance of the same group shares one block")
+    {
+      REQUIRE(nested.entries == std::vector<int>{10, 11});
+      for (auto id : ids)
+        REQUIRE(id == 0);
+    }
+
+    WHEN("The nested group is instanced in the world after another group")
+    {
+      InstanceLeafTable<int> world;
+      const int otherGroup = 0;
+
+      world.blockOffset(&otherGroup, [](auto &e) { e.push_back(1); });
+
+      // the nested group's block: its own GAS, then its nested table
+      const uint32_t base = world.blockOffset(&nestedGroup, [&](auto &e) {
+        e.push_back(20);
+        e.insert(e.end(), nested.entries.begin(), nested.entries.end());
+      });
+
+      THEN("The block follows the earlier one")
+      {
+        REQUIRE(base == 1);
+        REQUIRE(world.entries == std::vector<int>{1, 20, 10, 11});
+      }
+
+      THEN("Summed instance IDs along the transform list find the leaf data")
+      {
+        // world instance -> nested IAS has ID base + 1 (after its own GAS),
+        // nested instance -> leaf GAS #2 has ID 0 + 1
+        const uint32_t outerID = base + 1;
+        const uint32_t innerID = ids[42] + 1;
+        REQUIRE(world.entries[outerID + innerID] == 11);
+        // the nested group's own GAS is reached through one level only
+        REQUIRE(world.entries[base] == 20);
+      }
+    }
+  }
+
+  GIVEN("A cleared table")
+  {
+    InstanceLeafTable<int> table;
+    table.blockOffset(&leafGroup, appendLeafGroup);
+    table.clear();
+
+    THEN("Blocks are registered again from the start")
+    {
+      REQUIRE(table.entries.empty());
+      REQUIRE(table.blockOffset(&nestedGroup, appendLeafGroup) == 0);
+      REQUIRE(table.entries.size() == 2);
+    }
+  }
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "scene/InstanceSnapshot.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+namespace {
+
+struct SyntheticInstance
+{
+  int group;
+  std::vector<mat4x3> xfms;
+};
+
+// stand-ins for groups: surfaces only, surfaces + volume + lights, volume only
+std::vector<InstancedGroup> syntheticGroups()
+{
+  std::vector<InstancedGroup> groups(3);
+
+  groups[0].surfaces = {100, 101, 0};
+  groups[0].numSurfaces = 2;
+  groups[0].surfaceID = 0;
+
+  groups[1].surfaces = {200, 0, 0};
+  groups[1].numSurfaces = 1;
+  groups[1].surfaceID = 2;
+  groups[1].volumes = {300, 0};
+  groups[1].numVolumes = 1;
+  groups[1].volumeID = 0;
+  groups[1].hasLights = true;
+  groups[1].lights.numLights = 4;
+
+  groups[2].volumes = {400, 0};
+  groups[2].numVolumes = 1;
+  groups[2].volumeID = 1;
+
+  return groups;
+}
+
+void snapshotInstances(InstanceSnapshot &snapshot,
+    const std::vector<InstancedGroup> &groups,
+    const std::vector<SyntheticInstance> &instances)
+{
+  snapshot.clear();
+  for (const auto &inst : instances) {
+    const auto *key = &groups[inst.group];
+    const auto g = snapshot.groupIndex(key, [&]() { return *key; });
+    snapshot.addInstance(g, inst.xfms.size());
+  }
+  snapshot.computeOffsets();
+  snapshot.gatherTransforms(
+      [&](size_t i, size_t t) { return instances[i].xfms[t]; });
+}
+
+mat4x3 translation(float x)
+{
+  mat4x3 xfm(1);
+  xfm[3] = vec3(x, 0.f, 0.f);
+  return xfm;
+}
+
+} // namespace
+
+SCENARIO("Instance snapshots write every TLAS slot once", "[InstanceSnapshot]")
+{
+  const auto groups = syntheticGroups();
+
+  GIVEN("Instances of different groups, one with a transform array")
+  {
+    std::vector<SyntheticInstance> instances = {
+        {0, {translation(1.f)}},
+        {1, {translation(2.f), translation(3.f), translation(4.f)}},
+        {2, {translation(5.f)}},
+        {0, {translation(6.f)}}};
+
+    InstanceSnapshot snapshot;
+    snapshotInstances(snapshot, groups, instances);
+
+    THEN("Groups are registered once each")
+    {
+      REQUIRE(snapshot.groups.size() == 3);
+      REQUIRE(snapshot.instanceGroups[0] == snapshot.instanceGroups[3]);
+    }
+
+    THEN("Outputs are counted per BVH and transform")
+    {
+      REQUIRE(snapshot.numInstances() == 4);
+      REQUIRE(snapshot.xfms.size() == 6);
+      REQUIRE(snapshot.numSurfaceInstances() == 2 + 3 + 0 + 2);
+      REQUIRE(snapshot.numVolumeInstances() == 0 + 3 + 1 + 0);
+      REQUIRE(snapshot.numLightInstances() == 1);
+    }
+
+    THEN("Each instance writes its own slots with its group's IDs")
+    {
+      std::vector<OptixInstance> surfaces(snapshot.numSurfaceInstances());
+      std::vector<OptixInstance> volumes(snapshot.numVolumeInstances());
+      snapshot.writeOptixInstances(surfaces.data(), volumes.data());
+
+      // transform rows are [R | t], so translation x is element 3
+      REQUIRE(surfaces[0].traversableHandle == 100);
+      REQUIRE(surfaces[0].instanceId == 0);
+      REQUIRE(surfaces[0].transform[3] == 1.f);
+      REQUIRE(surfaces[1].traversableHandle == 101);
+      REQUIRE(surfaces[1].instanceId == 1);
+
+      for (int t = 0; t < 3; t++) {
+        REQUIRE(surfaces[2 + t].traversableHandle == 200);
+        REQUIRE(surfaces[2 + t].instanceId == 2);
+        REQUIRE(surfaces[2 + t].transform[3] == 2.f + t);
+        REQUIRE(volumes[t].traversableHandle == 300);
+        REQUIRE(volumes[t].transform[3] == 2.f + t);
+      }
+
+      REQUIRE(volumes[3].traversableHandle == 400);
+      REQUIRE(volumes[3].instanceId == 1);
+      REQUIRE(surfaces[5].transform[3] == 6.f);
+      REQUIRE(surfaces[6].traversableHandle == 101);
+    }
+
+    THEN("Only instances of groups with lights write light instances")
+    {
+      std::vector<InstanceLightGPUData> lights(snapshot.numLightInstances());
+      snapshot.writeLightInstances(lights.data());
+      REQUIRE(lights[0].numLights == 4);
+    }
+  }
+
+  GIVEN("Written OptixInstances of masked instances")
+  {
+    std::vector<SyntheticInstance> instances = {
+        {0, {translation(1.f)}}, {1, {translation(2.f), translation(3.f)}}};
+
+    InstanceSnapshot snapshot;
+    snapshot.clear();
+    for (const auto &inst : instances) {
+      const auto *key = &groups[inst.group];
+      const auto g = snapshot.groupIndex(key, [&]() { return *key; });
+      snapshot.addInstance(g, inst.xfms.size(), 0x3);
+    }
+    snapshot.computeOffsets();
+    snapshot.gatherTransforms(
+        [&](size_t i, size_t t) { return instances[i].xfms[t]; });
+
+    std::vector<OptixInstance> surfaces(snapshot.numSurfaceInstances());
+    std::vector<OptixInstance> volumes(snapshot.numVolumeInstances());
+    snapshot.writeOptixInstances(surfaces.data(), volumes.data());
+
+    THEN("Every record carries its instance's mask")
+    {
+      for (const auto &s : surfaces)
+        REQUIRE(s.visibilityMask == 0x3);
+      for (const auto &v : volumes)
+        REQUIRE(v.visibilityMask == 0x3);
+    }
+
+    WHEN("Only the second instance is hidden")
+    {
+      const bool changed =
+          snapshot.updateMasks([](size_t i) { return i == 1 ? 0 : 0x3; });
+      const auto before = surfaces;
+      snapshot.writeMasks(surfaces.data(), volumes.data());
+
+      THEN("Only its records' masks are patched")
+      {
+        REQUIRE(changed);
+        REQUIRE(surfaces[0].visibilityMask == 0x3);
+        REQUIRE(surfaces[1].visibilityMask == 0x3);
+        for (size_t i = 2; i < surfaces.size(); i++) {
+          REQUIRE(surfaces[i].visibilityMask == 0);
+          REQUIRE(surfaces[i].traversableHandle == before[i].traversableHandle);
+          REQUIRE(surfaces[i].transform[3] == before[i].transform[3]);
+        }
+        for (const auto &v : volumes)
+          REQUIRE(v.visibilityMask == 0);
+      }
+
+      THEN("Applying the same masks again reports no change")
+      {
+        REQUIRE(!snapshot.updateMasks(
+            [](size_t i) { return i == 1 ? 0 : 0x3; }));
+      }
+    }
+  }
+
+  GIVEN("A cleared snapshot")
+  {
+    InstanceSnapshot snapshot;
+    snapshotInstances(snapshot, groups, {{0, {translation(1.f)}}});
+    snapshot.clear();
+    snapshot.computeOffsets();
+
+    THEN("It has no outputs")
+    {
+      REQUIRE(snapshot.numInstances() == 0);
+      REQUIRE(snapshot.numSurfaceInstances() == 0);
+      REQUIRE(snapshot.numLightInstances() == 0);
+      REQUIRE(snapshot.groups.empty());
+    }
+  }
+}
+
+TEST_CASE("Instance snapshot of 1M instances", "[.benchmark]")
+{
+  const auto groups = syntheticGroups();
+
+  std::vector<SyntheticInstance> instances(1000000);
+  for (size_t i = 0; i < instances.size(); i++)
+    instances[i] = {int(i % groups.size()), {translation(float(i))}};
+
+  InstanceSnapshot snapshot;
+  std::vector<OptixInstance> surfaces;
+  std::vector<OptixInstance> volumes;
+  std::vector<InstanceLightGPUData> lights;
+
+  BENCHMARK("snapshot + write TLAS records")
+  {
+    snapshotInstances(snapshot, groups, instances);
+    surfaces.resize(snapshot.numSurfaceInstances());
+    volumes.resize(snapshot.numVolumeInstances());
+    lights.resize(snapshot.numLightInstances());
+    snapshot.writeOptixInstances(surfaces.data(), volumes.data());
+    snapshot.writeLightInstances(lights.data());
+    return surfaces.size();
+  };
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "utility/MappedFile.h"
+// std
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace visrtx;
+
+namespace {
+
+struct TempFile
+{
+  TempFile(const std::vector<uint8_t> &contents)
+  {
+    std::random_device rd;
+    auto path = std::filesystem::temp_directory_path()
+        / ("visrtx_test_MappedFile_" + std::to_string(rd()));
+    filename = path.string();
+
+    auto *fp = std::fopen(filename.c_str(), "wb");
+    if (!fp)
+      throw std::runtime_error("unable to create temporary file");
+    std::fwrite(contents.data(), 1, contents.size(), fp);
+    std::fclose(fp);
+  }
+
+  ~TempFile()
+  {
+    std::remove(filename.c_str());
+  }
+
+  std::string filename;
+};
+
+std::vector<uint8_t> makeContents(size_t numBytes)
+{
+  std::vector<uint8_t> contents(numBytes);
+  for (size_t i = 0; i < numBytes; i++)
+    contents[i] = uint8_t(i * 7 + i / 251);
+  return contents;
+}
+
+bool matchesContents(const MappedFile &file,
+    const std::vector<uint8_t> &contents,
+    size_t offset)
+{
+  for (size_t i = 0; i < file.size(); i++) {
+    if (file.data()[i] != contents[offset + i])
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+SCENARIO("Byte ranges of a file are mapped read-only", "[MappedFile]")
+{
+  GIVEN("A file spanning several pages")
+  {
+    const auto contents = makeContents(3 * 4096 + 123);
+    TempFile tmp(contents);
+
+    THEN("The whole file is mapped by default")
+    {
+      MappedFile file(tmp.filename, 0);
+      REQUIRE(file);
+      REQUIRE(file.size() == contents.size());
+      REQUIRE(matchesContents(file, contents, 0));
+    }
+
+    THEN("Offsets which are not page aligned map the requested bytes")
+    {
+      for (size_t offset : {size_t(1), size_t(4095), size_t(4097)}) {
+        MappedFile file(tmp.filename, offset, 1000);
+        REQUIRE(file.size() == 1000);
+        REQUIRE(matchesContents(file, contents, offset));
+      }
+    }
+
+    THEN("Mapping from an offset to the end of the file uses the remainder")
+    {
+      MappedFile file(tmp.filename, 5000);
+      REQUIRE(file.size() == contents.size() - 5000);
+      REQUIRE(matchesContents(file, contents, 5000));
+    }
+
+    THEN("Ranges beyond the end of the file are rejected")
+    {
+      REQUIRE_THROWS_AS(
+          MappedFile(tmp.filename, 10, contents.size()), std::runtime_error);
+      REQUIRE_THROWS_AS(
+          MappedFile(tmp.filename, contents.size() + 1), std::runtime_error);
+    }
+
+    THEN("Missing files are rejected")
+    {
+      REQUIRE_THROWS_AS(MappedFile(tmp.filename + ".missing", 0),
+          std::runtime_error);
+    }
+
+    THEN("Prefetching accepts unaligned ranges within the mapping only")
+    {
+      MappedFile file(tmp.filename, 17);
+      REQUIRE(file.prefetch());
+      REQUIRE(file.prefetch(5, 5000));
+      REQUIRE(file.prefetch(4000, 1 << 20));
+      REQUIRE(!file.prefetch(file.size()));
+      REQUIRE(!MappedFile().prefetch());
+    }
+  }
+}
+
+SCENARIO("Mapped files are streamed in chunks", "[MappedFile]")
+{
+  GIVEN("A mapping which is not a multiple of the chunk size")
+  {
+    const auto contents = makeContents(10000);
+    TempFile tmp(contents);
+    MappedFile file(tmp.filename, 3);
+
+    THEN("Chunks are consecutive, cover the mapping and only the last is short")
+    {
+      for (bool prefetch : {true, false}) {
+        std::vector<uint8_t> streamed(file.size());
+        std::vector<size_t> chunkSizes;
+        size_t expectedOffset = 0;
+        auto numChunks = file.forEachChunk(
+            4096,
+            [&](const uint8_t *chunk, size_t offset, size_t numBytes) {
+              REQUIRE(offset == expectedOffset);
+              REQUIRE(chunk == file.data() + offset);
+              std::copy(chunk, chunk + numBytes, streamed.begin() + offset);
+              chunkSizes.push_back(numBytes);
+              expectedOffset += numBytes;
+            },
+            prefetch);
+
+        REQUIRE(numChunks == 3);
+        REQUIRE(chunkSizes == std::vector<size_t>{4096, 4096, 1805});
+        REQUIRE(std::equal(
+            streamed.begin(), streamed.end(), contents.begin() + 3));
+      }
+    }
+
+    THEN("A zero chunk size uses the default, a single chunk here")
+    {
+      size_t numBytesSeen = 0;
+      auto numChunks = file.forEachChunk(
+          0, [&](const uint8_t *, size_t, size_t n) { numBytesSeen += n; });
+      REQUIRE(numChunks == 1);
+      REQUIRE(numBytesSeen == file.size());
+    }
+  }
+}
+
+SCENARIO("Mappings are owned by exactly one MappedFile", "[MappedFile]")
+{
+  GIVEN("A mapped file")
+  {
+    const auto contents = makeContents(8192);
+    TempFile tmp(contents);
+    MappedFile file(tmp.filename, 100, 200);
+    const uint8_t *data = file.data();
+
+    THEN("Moving transfers the mapping and empties the source")
+    {
+      MappedFile moved(std::move(file));
+      REQUIRE(moved.data() == data);
+      REQUIRE(moved.size() == 200);
+      REQUIRE(!file);
+      REQUIRE(file.data() == nullptr);
+      REQUIRE(file.size() == 0);
+
+      MappedFile assigned;
+      assigned = std::move(moved);
+      REQUIRE(assigned.data() == data);
+      REQUIRE(matchesContents(assigned, contents, 100));
+      REQUIRE(!moved);
+    }
+
+    THEN("Move assignment releases the previous mapping of the target")
+    {
+      MappedFile other(tmp.filename, 0, 10);
+      other = std::move(file);
+      REQUIRE(other.data() == data);
+      REQUIRE(other.size() == 200);
+    }
+
+    THEN("The mapping stays valid after the file is removed")
+    {
+      std::remove(tmp.filename.c_str());
+      REQUIRE(matchesContents(file, contents, 100));
+    }
+
+    THEN("Reset releases the mapping")
+    {
+      file.reset();
+      REQUIRE(!file);
+      REQUIRE(file.size() == 0);
+      REQUIRE(file.forEachChunk(16, [](const uint8_t *, size_t, size_t) {})
+          == 0);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "gpu/gpu_objects.h"
+#include "scene/MeshSplit.h"
+// std
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace visrtx;
+
+// A row of 'n' unit triangles along x, in reverse order
+static std::vector<vec3> triangleRow(size_t n)
+{
+  std::vector<vec3> vertices;
+  for (size_t i = 0; i < n; i++) {
+    const float x = float(n - 1 - i);
+    vertices.push_back(vec3(x, 0.f, 0.f));
+    vertices.push_back(vec3(x + 1.f, 0.f, 0.f));
+    vertices.push_back(vec3(x, 1.f, 0.f));
+  }
+  return vertices;
+}
+
+SCENARIO("Morton codes order points along the Z curve", "[MeshSplit]")
+{
+  const box3 bounds(vec3(0.f), vec3(1.f));
+
+  REQUIRE(mortonCode(vec3(0.f), bounds) == 0);
+  REQUIRE(mortonCode(vec3(1.f), bounds) == 0x3FFFFFFF);
+  REQUIRE(mortonCode(vec3(1.f, 0.f, 0.f), bounds) == 0x24924924);
+  REQUIRE(mortonCode(vec3(0.f, 0.f, 1.f), bounds) == 0x09249249);
+  REQUIRE(mortonCode(vec3(2.f), bounds) == mortonCode(vec3(1.f), bounds));
+}
+
+SCENARIO("Huge triangle meshes are split into spatially coherent chunks",
+    "[MeshSplit]")
+{
+  GIVEN("A non-indexed mesh of 10 triangles split into chunks of at most 4")
+  {
+    const auto vertices = triangleRow(10);
+    const TriangleMesh mesh = {vertices.data(), vertices.size(), nullptr, 10};
+
+    const auto split = splitTriangleMesh(mesh, 4);
+
+    THEN("The fewest equally sized chunks are used")
+    {
+      REQUIRE(split.numChunks() == 3);
+      REQUIRE(split.chunkOffsets == std::vector<uint32_t>{0, 3, 6, 10});
+    }
+
+    THEN("Every triangle is in exactly one chunk, ordered along the curve")
+    {
+      std::vector<uint32_t> expected(10);
+      std::iota(expected.rbegin(), expected.rend(), 0);
+      REQUIRE(split.primIDs == expected);
+    }
+
+    THEN("Chunk indices reference the original vertices")
+    {
+      const auto indices = chunkIndices(mesh, split, 1);
+      REQUIRE(indices.size() == 3);
+      REQUIRE(indices[0] == uvec3(18, 19, 20));
+      REQUIRE(indices[2] == uvec3(12, 13, 14));
+    }
+  }
+
+  GIVEN("An indexed mesh smaller than the chunk size")
+  {
+    const auto vertices = triangleRow(3);
+    const std::vector<uvec3> indices = {
+        uvec3(6, 7, 8), uvec3(0, 1, 2), uvec3(3, 4, 5)};
+    const TriangleMesh mesh = {vertices.data(), 9, indices.data(), 3};
+
+    const auto split = splitTriangleMesh(mesh, 4);
+
+    THEN("A single chunk gathers the indexed triangles")
+    {
+      REQUIRE(split.numChunks() == 1);
+      REQUIRE(split.primIDs == std::vector<uint32_t>{0, 2, 1});
+      REQUIRE(chunkIndices(mesh, split, 0)
+          == std::vector<uvec3>{indices[0], indices[2], indices[1]});
+    }
+  }
+}
+
+SCENARIO("Hits on a chunk GAS resolve to the split geometry's primitive",
+    "[MeshSplit]")
+{
+  const std::vector<DeviceObjectIndex> surface = {7};
+  const std::vector<uint32_t> primIDs = {9, 8, 7, 6, 5, 4};
+  const InstanceSurfaceGPUData chunk = {
+      surface.data(), nullptr, nullptr, primIDs.data() + 3};
+
+  const auto s = findSurfaceSlot(chunk, 0, 2);
+  REQUIRE(s.slot == 0);
+  REQUIRE(s.primID == 4);
+}
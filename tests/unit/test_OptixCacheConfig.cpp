@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "utility/OptixCacheConfig.h"
+
+using namespace visrtx;
+
+SCENARIO("Byte size parsing", "[OptixCacheConfig]")
+{
+  REQUIRE(parseByteSize("1048576") == 1048576ull);
+  REQUIRE(parseByteSize("512K") == 512ull << 10);
+  REQUIRE(parseByteSize("256m") == 256ull << 20);
+  REQUIRE(parseByteSize("2G") == 2ull << 30);
+  REQUIRE(!parseByteSize(nullptr));
+  REQUIRE(!parseByteSize(""));
+  REQUIRE(!parseByteSize("lots"));
+  REQUIRE(!parseByteSize("10X"));
+  REQUIRE(!parseByteSize("10MB"));
+  REQUIRE(!parseByteSize("-1"));
+  REQUIRE(!parseByteSize("-1G"));
+  REQUIRE(!parseByteSize(" -1"));
+  REQUIRE(!parseByteSize("+1"));
+  REQUIRE(parseByteSize("17179869183G") == 17179869183ull << 30);
+  REQUIRE(!parseByteSize("17179869184G"));
+  REQUIRE(!parseByteSize("18446744073709551616"));
+}
+
+SCENARIO("OptiX cache config resolution", "[OptixCacheConfig]")
+{
+  GIVEN("No parameters or environment variables")
+  {
+    auto config = resolveOptixCacheConfig({}, nullptr, nullptr);
+
+    THEN("The cache is enabled with OptiX defaults")
+    {
+      REQUIRE(config.enabled);
+      REQUIRE(config.location.empty());
+      REQUIRE(config.highWaterMark == 0);
+      REQUIRE(config.lowWaterMark == 0);
+    }
+  }
+
+  GIVEN("Only environment variables")
+  {
+    auto config = resolveOptixCacheConfig({}, "/tmp/env_cache", "64M");
+
+    THEN("They are used, with eviction down to half the max size")
+    {
+      REQUIRE(config.enabled);
+      REQUIRE(config.location == "/tmp/env_cache");
+      REQUIRE(config.highWaterMark == 64ull << 20);
+      REQUIRE(config.lowWaterMark == 32ull << 20);
+    }
+  }
+
+  GIVEN("Parameters and environment variables")
+  {
+    OptixCacheParameters params;
+    params.location = "/tmp/param_cache";
+    params.maxBytes = 1000;
+    auto config = resolveOptixCacheConfig(params, "/tmp/env_cache", "64M");
+
+    THEN("Parameters take precedence")
+    {
+      REQUIRE(config.location == "/tmp/param_cache");
+      REQUIRE(config.highWaterMark == 1000);
+      REQUIRE(config.lowWaterMark == 500);
+    }
+  }
+
+  GIVEN("A location of 'off'")
+  {
+    auto config = resolveOptixCacheConfig({}, "off", "64M");
+
+    THEN("The cache is disabled")
+    {
+      REQUIRE(!config.enabled);
+      REQUIRE(config.location.empty());
+      REQUIRE(config.highWaterMark == 0);
+    }
+
+    AND_WHEN("The cache is explicitly enabled by parameter")
+    {
+      OptixCacheParameters params;
+      params.enabled = true;
+      auto config2 = resolveOptixCacheConfig(params, "off", nullptr);
+
+      THEN("The cache is enabled at the default location")
+      {
+        REQUIRE(config2.enabled);
+        REQUIRE(config2.location.empty());
+      }
+    }
+  }
+
+  GIVEN("An invalid size in the environment")
+  {
+    auto config = resolveOptixCacheConfig({}, nullptr, "huge");
+
+    THEN("The size is left to OptiX")
+    {
+      REQUIRE(config.highWaterMark == 0);
+    }
+  }
+}
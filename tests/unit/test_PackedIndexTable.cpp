@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "scene/PackedIndexTable.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("Index lists of many groups are packed into one table",
+    "[PackedIndexTable]")
+{
+  GIVEN("Leaves referencing lists owned by two groups")
+  {
+    const std::vector<DeviceObjectIndex> surfacesA = {3, 4, 5};
+    const std::vector<uint32_t> inputSlotsA = {0, 1, 3};
+    const std::vector<uint32_t> slotPrimsA = {0, 0, 12};
+    const std::vector<DeviceObjectIndex> surfacesB = {7};
+    const std::vector<DeviceObjectIndex> volumesB = {1, 2};
+    const std::vector<DeviceObjectIndex> noLights;
+
+    SurfaceLeaf a;
+    a.surfaces = surfacesA;
+    a.inputSlots = inputSlotsA;
+    a.slotPrims = slotPrimsA;
+
+    SurfaceLeaf b;
+    b.surfaces = surfacesB;
+
+    const VolumeLeaf v = {volumesB};
+
+    PackedIndexTable table;
+    for (const auto &leaf : {a, b, a}) {
+      table.add(leaf.surfaces);
+      table.add(leaf.inputSlots);
+      table.add(leaf.slotPrims);
+    }
+    table.add(v.volumes);
+    table.add(noLights);
+
+    THEN("Each list is packed once, in order")
+    {
+      REQUIRE(table.data
+          == std::vector<uint32_t>{3, 4, 5, 0, 1, 3, 0, 0, 12, 7, 1, 2});
+    }
+
+    THEN("Leaves resolve to addresses in the (device) copy of the table")
+    {
+      const auto copy = table.data;
+
+      const auto ga = table.resolve(a, copy.data());
+      REQUIRE(ga.surfaces == (const DeviceObjectIndex *)copy.data());
+      REQUIRE(ga.inputSlots == copy.data() + 3);
+      REQUIRE(ga.slotPrims == copy.data() + 6);
+      REQUIRE(ga.primIDs == nullptr);
+      REQUIRE(ga.inputSlots[2] == 3);
+
+      const auto gb = table.resolve(b, copy.data());
+      REQUIRE(gb.surfaces[0] == 7);
+      REQUIRE(gb.inputSlots == nullptr);
+      REQUIRE(gb.slotPrims == nullptr);
+
+      const auto gv = table.resolve(v, copy.data());
+      REQUIRE(gv.volumes[1] == 2);
+
+      REQUIRE(table.find(noLights, copy.data()) == nullptr);
+    }
+
+    THEN("Clearing the table forgets the packed lists")
+    {
+      table.clear();
+      REQUIRE(table.data.empty());
+      table.add(b.surfaces);
+      REQUIRE(table.data == std::vector<uint32_t>{7});
+    }
+  }
+}
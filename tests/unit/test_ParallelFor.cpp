@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "utility/ParallelFor.h"
+// std
+#include <atomic>
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("Parallel loops visit every index once", "[ParallelFor]")
+{
+  GIVEN("A range spanning many chunks")
+  {
+    std::vector<int> visits(100000, 0);
+    parallelFor(visits.size(), [&](size_t i) { visits[i]++; }, 1000);
+
+    THEN("Each index is visited exactly once")
+    {
+      bool allOnce = true;
+      for (auto v : visits)
+        allOnce &= v == 1;
+      REQUIRE(allOnce);
+    }
+  }
+
+  GIVEN("A range smaller than one chunk")
+  {
+    std::atomic<size_t> count{0};
+    parallelFor(10, [&](size_t) { count++; });
+
+    THEN("It runs serially over the whole range")
+    {
+      REQUIRE(count == 10);
+    }
+  }
+
+  GIVEN("An empty range")
+  {
+    std::atomic<size_t> count{0};
+    parallelFor(0, [&](size_t) { count++; });
+
+    THEN("Nothing is called")
+    {
+      REQUIRE(count == 0);
+    }
+  }
+
+  GIVEN("A chunk size of zero")
+  {
+    std::vector<int> visits(37, 0);
+    parallelFor(visits.size(), [&](size_t i) { visits[i]++; }, 0);
+
+    THEN("It is treated as one item per chunk")
+    {
+      bool allOnce = true;
+      for (auto v : visits)
+        allOnce &= v == 1;
+      REQUIRE(allOnce);
+    }
+  }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "utility/RefCountedCache.h"
+// std
+#include <string>
+
+using namespace visrtx;
+
+SCENARIO("Shared cache entries live while referenced", "[RefCountedCache]")
+{
+  RefCountedCache<std::string, int> cache;
+  int builds = 0;
+  auto build = [&](int &entry) {
+    entry = 42;
+    builds++;
+    return size_t(100);
+  };
+
+  GIVEN("Two acquisitions of the same key")
+  {
+    auto a = cache.acquire("mesh", build);
+    auto b = cache.acquire("mesh", build);
+
+    THEN("The entry is built once and shared")
+    {
+      REQUIRE(builds == 1);
+      REQUIRE(a == b);
+      REQUIRE(*a == 42);
+      REQUIRE(cache.refCount("mesh") == 2);
+      REQUIRE(cache.numEntries() == 1);
+      REQUIRE(cache.bytes() == 100);
+    }
+
+    WHEN("One reference is released")
+    {
+      a.reset();
+
+      THEN("The entry stays cached")
+      {
+        REQUIRE(cache.refCount("mesh") == 1);
+        REQUIRE(cache.bytes() == 100);
+      }
+    }
+
+    WHEN("Every reference is released")
+    {
+      a.reset();
+      b.reset();
+
+      THEN("The entry and its memory are dropped")
+      {
+        REQUIRE(cache.refCount("mesh") == 0);
+        REQUIRE(cache.numEntries() == 0);
+        REQUIRE(cache.bytes() == 0);
+      }
+
+      THEN("Acquiring the key again rebuilds it")
+      {
+        auto c = cache.acquire("mesh", build);
+        REQUIRE(builds == 2);
+        REQUIRE(cache.bytes() == 100);
+      }
+    }
+  }
+
+  GIVEN("Entries of different keys")
+  {
+    auto a = cache.acquire("mesh", build);
+    auto b = cache.acquire("spheres", [](int &entry) {
+      entry = 7;
+      return size_t(20);
+    });
+
+    THEN("Memory of both is accounted for")
+    {
+      REQUIRE(*b == 7);
+      REQUIRE(cache.numEntries() == 2);
+      REQUIRE(cache.bytes() == 120);
+    }
+  }
+
+  GIVEN("An entry outliving its cache")
+  {
+    std::shared_ptr<int> entry;
+    {
+      RefCountedCache<std::string, int> shortLived;
+      entry = shortLived.acquire("mesh", build);
+    }
+
+    THEN("It remains valid until released")
+    {
+      REQUIRE(*entry == 42);
+      entry.reset();
+    }
+  }
+}
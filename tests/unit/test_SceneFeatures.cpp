@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "scene/SceneFeatures.h"
+
+using namespace visrtx;
+
+static MaterialGPUData packMaterial(const MaterialParameters &p)
+{
+  MaterialGPUData md;
+  MaterialVaryingGPUData mv;
+  packMaterialParameters(p, md, mv);
+  return md;
+}
+
+SCENARIO("Scene feature derivation", "[SceneFeatures]")
+{
+  GIVEN("An empty scene")
+  {
+    SceneSummary s;
+
+    THEN("No optional features are used")
+    {
+      REQUIRE(deriveSceneFeatures(s) == 0);
+    }
+  }
+
+  GIVEN("A scene with only opaque triangle surfaces and one light")
+  {
+    SceneSummary s;
+    s.numLights = 1;
+
+    THEN("Only the single light class is set")
+    {
+      REQUIRE(deriveSceneFeatures(s) == SCENE_FEATURE_LIGHTS_ONE);
+    }
+  }
+
+  GIVEN("A scene using every feature")
+  {
+    SceneSummary s;
+    s.numVolumeInstances = 2;
+    s.numUserGeometryInstances = 1;
+    s.numNonOpaqueSurfaces = 3;
+    s.numLights = 4;
+
+    const auto features = deriveSceneFeatures(s);
+
+    THEN("Every feature is set")
+    {
+      REQUIRE(features & SCENE_FEATURE_VOLUMES);
+      REQUIRE(features & SCENE_FEATURE_NON_OPAQUE);
+      REQUIRE(features & SCENE_FEATURE_USER_GEOMETRY);
+      REQUIRE(features & SCENE_FEATURE_LIGHTS_MANY);
+      REQUIRE_FALSE(features & SCENE_FEATURE_LIGHTS_ONE);
+    }
+
+    THEN("The features equal the unspecialized set")
+    {
+      REQUIRE(features == SCENE_FEATURES_ALL);
+    }
+  }
+}
+
+SCENARIO("Single GAS detection", "[SceneFeatures]")
+{
+  GIVEN("A world with one identity instance of triangle surfaces")
+  {
+    SceneSummary s;
+    s.numInstances = 1;
+    s.numTriangleInstances = 1;
+
+    THEN("It is traced as a single GAS")
+    {
+      REQUIRE(deriveSceneFeatures(s) & SCENE_FEATURE_SINGLE_GAS);
+    }
+
+    WHEN("The instance also has volumes")
+    {
+      s.numVolumeInstances = 1;
+
+      THEN("Surfaces and volumes are still separate single GASes")
+      {
+        REQUIRE(deriveSceneFeatures(s) & SCENE_FEATURE_SINGLE_GAS);
+      }
+    }
+
+    WHEN("The instance also has user geometry")
+    {
+      s.numUserGeometryInstances = 1;
+
+      THEN("An IAS is needed over both surface GASes")
+      {
+        REQUIRE_FALSE(deriveSceneFeatures(s) & SCENE_FEATURE_SINGLE_GAS);
+      }
+    }
+
+    WHEN("The instance is transformed")
+    {
+      s.identityInstances = false;
+
+      THEN("An IAS is needed to apply the transform")
+      {
+        REQUIRE_FALSE(deriveSceneFeatures(s) & SCENE_FEATURE_SINGLE_GAS);
+      }
+    }
+  }
+
+  GIVEN("A world with one identity instance of a group of instances")
+  {
+    SceneSummary s;
+    s.numInstances = 1;
+    s.numTriangleInstances = 1;
+    s.instancingDepth = 1;
+
+    THEN("Nested instancing is used instead of a single GAS")
+    {
+      const auto features = deriveSceneFeatures(s);
+      REQUIRE(features & SCENE_FEATURE_NESTED_INSTANCING);
+      REQUIRE_FALSE(features & SCENE_FEATURE_SINGLE_GAS);
+    }
+  }
+
+  GIVEN("A world with two identity instances")
+  {
+    SceneSummary s;
+    s.numInstances = 2;
+    s.numTriangleInstances = 2;
+
+    THEN("An IAS is needed")
+    {
+      REQUIRE_FALSE(deriveSceneFeatures(s) & SCENE_FEATURE_SINGLE_GAS);
+    }
+  }
+}
+
+SCENARIO("Generic pipeline variants", "[SceneFeatures]")
+{
+  GIVEN("Worlds traversed through a single level of instances")
+  {
+    THEN("Every feature set is served by the fully generic variant")
+    {
+      REQUIRE(genericSceneFeatures(0) == SCENE_FEATURES_ALL);
+      REQUIRE(genericSceneFeatures(SCENE_FEATURE_VOLUMES
+                  | SCENE_FEATURE_LIGHTS_ONE)
+          == SCENE_FEATURES_ALL);
+      REQUIRE(genericSceneFeatures(SCENE_FEATURES_ALL) == SCENE_FEATURES_ALL);
+    }
+  }
+
+  GIVEN("Worlds with a different traversal structure")
+  {
+    THEN("The generic variant keeps the structure, which it can't check")
+    {
+      REQUIRE(genericSceneFeatures(SCENE_FEATURE_SINGLE_GAS)
+          == (SCENE_FEATURES_ALL | SCENE_FEATURE_SINGLE_GAS));
+      REQUIRE(genericSceneFeatures(
+                  SCENE_FEATURE_NESTED_INSTANCING | SCENE_FEATURE_VOLUMES)
+          == (SCENE_FEATURES_ALL | SCENE_FEATURE_NESTED_INSTANCING));
+    }
+
+    THEN("Generic variants are their own generic variant")
+    {
+      const uint32_t generic = genericSceneFeatures(SCENE_FEATURE_SINGLE_GAS);
+      REQUIRE(genericSceneFeatures(generic) == generic);
+    }
+  }
+}
+
+SCENARIO("Material opacity classification", "[SceneFeatures]")
+{
+  GIVEN("A default material")
+  {
+    MaterialParameters p;
+
+    THEN("It is opaque")
+    {
+      REQUIRE(materialIsOpaque(packMaterial(p)));
+    }
+  }
+
+  GIVEN("A material with constant partial opacity")
+  {
+    MaterialParameters p;
+    p.opacity = 0.5f;
+
+    THEN("It is not opaque")
+    {
+      REQUIRE_FALSE(materialIsOpaque(packMaterial(p)));
+    }
+  }
+
+  GIVEN("A material with opacity from a vertex attribute")
+  {
+    MaterialParameters p;
+    p.opacity.type = MaterialParameterType::ATTRIB_0;
+
+    THEN("It is not statically opaque")
+    {
+      REQUIRE_FALSE(materialIsOpaque(packMaterial(p)));
+    }
+  }
+}
+
+SCENARIO("Surface geometry flags", "[SceneFeatures]")
+{
+  GIVEN("A material with constant full opacity")
+  {
+    MaterialParameters p;
+    p.opacity = 1.f;
+
+    THEN("Its surfaces disable any-hit programs")
+    {
+      REQUIRE(surfaceGeometryFlags(materialIsOpaque(packMaterial(p)))
+          == OPTIX_GEOMETRY_FLAG_DISABLE_ANYHIT);
+    }
+  }
+
+  GIVEN("A material with opacity from a sampler")
+  {
+    MaterialParameters p;
+    p.opacity.type = MaterialParameterType::SAMPLER;
+    p.opacity.sampler = 0;
+
+    THEN("Its surfaces keep any-hit programs enabled")
+    {
+      REQUIRE(surfaceGeometryFlags(materialIsOpaque(packMaterial(p)))
+          == OPTIX_GEOMETRY_FLAG_NONE);
+    }
+  }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "utility/SlotAllocator.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+using Ranges = std::vector<SlotAllocator::Range>;
+
+SCENARIO("Slots are allocated with geometric growth", "[SlotAllocator]")
+{
+  GIVEN("A slot allocator")
+  {
+    SlotAllocator slots;
+
+    THEN("Capacity doubles, only growing when all slots are taken")
+    {
+      size_t numGrowths = 0;
+      for (uint32_t i = 0; i < 1000; i++) {
+        REQUIRE(slots.alloc() == i);
+        if (slots.capacityChanged()) {
+          numGrowths++;
+          slots.takeDirtyRanges();
+        }
+      }
+      REQUIRE(slots.capacity() == 1024);
+      REQUIRE(numGrowths == 7);
+      REQUIRE(slots.size() == 1000);
+    }
+
+    WHEN("Slots are freed")
+    {
+      for (int i = 0; i < 10; i++)
+        slots.alloc();
+      slots.takeDirtyRanges();
+      slots.free(3);
+      slots.free(7);
+
+      THEN("They are reused before growing, without any full update")
+      {
+        REQUIRE(slots.size() == 8);
+        REQUIRE(slots.alloc() == 7);
+        REQUIRE(slots.alloc() == 3);
+        REQUIRE(slots.alloc() == 10);
+        REQUIRE(!slots.capacityChanged());
+        REQUIRE(slots.numSlots() == 11);
+        REQUIRE(slots.size() == 11);
+      }
+    }
+  }
+}
+
+SCENARIO("Dirty slots are uploaded as coalesced ranges", "[SlotAllocator]")
+{
+  GIVEN("Slots of a grown array")
+  {
+    SlotAllocator slots;
+    for (int i = 0; i < 40; i++)
+      slots.alloc();
+
+    THEN("A capacity change updates all slots at once")
+    {
+      slots.markDirty(5);
+      REQUIRE(slots.hasDirtySlots());
+      REQUIRE(slots.takeDirtyRanges() == Ranges{{0, 40}});
+      REQUIRE(!slots.hasDirtySlots());
+      REQUIRE(slots.takeDirtyRanges().empty());
+    }
+
+    WHEN("Scattered slots are marked dirty afterwards")
+    {
+      slots.takeDirtyRanges();
+      for (uint32_t s : {20, 3, 4, 5, 4, 30, 9, 21})
+        slots.markDirty(s);
+
+      THEN("Adjacent (and repeated) slots form contiguous ranges")
+      {
+        REQUIRE(slots.takeDirtyRanges()
+            == Ranges{{3, 6}, {9, 10}, {20, 22}, {30, 31}});
+      }
+
+      THEN("Ranges separated by small gaps are merged")
+      {
+        REQUIRE(
+            slots.takeDirtyRanges(4) == Ranges{{3, 10}, {20, 22}, {30, 31}});
+      }
+
+      THEN("Dirty slots are cleared once taken")
+      {
+        slots.takeDirtyRanges();
+        REQUIRE(!slots.hasDirtySlots());
+      }
+    }
+  }
+}
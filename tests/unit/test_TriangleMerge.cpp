@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "gpu/gpu_objects.h"
+#include "scene/TriangleMerge.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("Small triangle surfaces are merged into shared build inputs",
+    "[TriangleMerge]")
+{
+  GIVEN("Small surfaces of two geometry flags around a large surface")
+  {
+    const std::vector<size_t> numTriangles = {10, 5000, 20, 30, 40};
+    const std::vector<uint32_t> flags = {1, 1, 2, 1, 2};
+    const std::vector<bool> mergeable(5, true);
+
+    const auto plan = planTriangleMerge(numTriangles, flags, mergeable);
+
+    THEN("The large surface keeps its own input, small ones merge by flags")
+    {
+      REQUIRE(plan.numSlots() == 5);
+      REQUIRE(plan.numInputs() == 3);
+      REQUIRE(plan.hasMerges());
+
+      REQUIRE(plan.slotSurfaces == std::vector<uint32_t>{1, 0, 3, 2, 4});
+      REQUIRE(plan.inputSlots == std::vector<uint32_t>{0, 1, 3, 5});
+      REQUIRE(plan.slotPrims == std::vector<uint32_t>{0, 0, 10, 0, 20});
+
+      REQUIRE(!plan.inputIsMerged(0));
+      REQUIRE(plan.inputIsMerged(1));
+      REQUIRE(plan.inputIsMerged(2));
+    }
+
+    THEN("Hits on merged inputs resolve to their surface and local primitive")
+    {
+      const std::vector<DeviceObjectIndex> surfaces = {11, 10, 13, 12, 14};
+      const InstanceSurfaceGPUData inst = {surfaces.data(),
+          plan.inputSlots.data(),
+          plan.slotPrims.data(),
+          nullptr};
+
+      auto hit = [&](uint32_t input, uint32_t primID) {
+        const auto s = findSurfaceSlot(inst, input, primID);
+        return std::make_pair(surfaces[s.slot], s.primID);
+      };
+
+      REQUIRE(hit(0, 4321) == std::make_pair(DeviceObjectIndex(11), 4321u));
+      REQUIRE(hit(1, 0) == std::make_pair(DeviceObjectIndex(10), 0u));
+      REQUIRE(hit(1, 9) == std::make_pair(DeviceObjectIndex(10), 9u));
+      REQUIRE(hit(1, 10) == std::make_pair(DeviceObjectIndex(13), 0u));
+      REQUIRE(hit(1, 39) == std::make_pair(DeviceObjectIndex(13), 29u));
+      REQUIRE(hit(2, 19) == std::make_pair(DeviceObjectIndex(12), 19u));
+      REQUIRE(hit(2, 59) == std::make_pair(DeviceObjectIndex(14), 39u));
+    }
+  }
+
+  GIVEN("Surfaces which cannot be merged")
+  {
+    const std::vector<size_t> numTriangles = {10, 0, 20, 30};
+    const std::vector<uint32_t> flags = {1, 1, 2, 1};
+    const std::vector<bool> mergeable = {true, true, true, false};
+
+    const auto plan = planTriangleMerge(numTriangles, flags, mergeable);
+
+    THEN("Each keeps its own input in order")
+    {
+      REQUIRE(!plan.hasMerges());
+      REQUIRE(plan.numInputs() == 4);
+      REQUIRE(plan.slotSurfaces == std::vector<uint32_t>{0, 1, 2, 3});
+    }
+
+    THEN("Hits resolve without a remap table")
+    {
+      const InstanceSurfaceGPUData inst = {nullptr, nullptr, nullptr, nullptr};
+      const auto s = findSurfaceSlot(inst, 2, 7);
+      REQUIRE(s.slot == 2);
+      REQUIRE(s.primID == 7);
+    }
+  }
+
+  GIVEN("More small triangles than fit one merged input")
+  {
+    const std::vector<size_t> numTriangles(10, 100);
+    const std::vector<uint32_t> flags(10, 0);
+    const std::vector<bool> mergeable(10, true);
+
+    const auto plan =
+        planTriangleMerge(numTriangles, flags, mergeable, 100, 350);
+
+    THEN("Merged inputs are split at the triangle limit")
+    {
+      REQUIRE(plan.inputSlots == std::vector<uint32_t>{0, 3, 6, 9, 10});
+      REQUIRE(plan.slotPrims[3] == 0);
+      REQUIRE(plan.slotPrims[5] == 200);
+    }
+  }
+}
+
+SCENARIO("Triangle meshes are concatenated", "[TriangleMerge]")
+{
+  GIVEN("An indexed and a non-indexed mesh")
+  {
+    const std::vector<vec3> quadVertices = {
+        vec3(0.f), vec3(1.f, 0.f, 0.f), vec3(1.f), vec3(0.f, 1.f, 0.f)};
+    const std::vector<uvec3> quadIndices = {uvec3(0, 1, 2), uvec3(0, 2, 3)};
+    const std::vector<vec3> soupVertices(6, vec3(2.f));
+
+    MergedTriangles merged;
+    merged.append({quadVertices.data(), 4, quadIndices.data(), 2});
+    merged.append({soupVertices.data(), 6, nullptr, 2});
+
+    THEN("Vertices are appended and indices offset to them")
+    {
+      REQUIRE(merged.vertices.size() == 10);
+      REQUIRE(merged.vertices[4] == vec3(2.f));
+      REQUIRE(merged.indices.size() == 4);
+      REQUIRE(merged.indices[1] == uvec3(0, 2, 3));
+      REQUIRE(merged.indices[2] == uvec3(4, 5, 6));
+      REQUIRE(merged.indices[3] == uvec3(7, 8, 9));
+    }
+  }
+
+  GIVEN("A mesh with 16-bit indices")
+  {
+    const std::vector<vec3> vertices(4, vec3(1.f));
+    const std::vector<u16vec3> indices = {
+        u16vec3(0, 1, 2), u16vec3(2, 3, 0)};
+
+    TriangleMesh mesh;
+    mesh.vertices = vertices.data();
+    mesh.numVertices = vertices.size();
+    mesh.shortIndices = indices.data();
+    mesh.numTriangles = indices.size();
+
+    MergedTriangles merged;
+    merged.append({vertices.data(), 4, nullptr, 1});
+    merged.append(mesh);
+
+    THEN("Its indices are widened and offset")
+    {
+      REQUIRE(mesh.triangle(1) == uvec3(2, 3, 0));
+      REQUIRE(merged.indices.size() == 3);
+      REQUIRE(merged.indices[1] == uvec3(4, 5, 6));
+      REQUIRE(merged.indices[2] == uvec3(6, 7, 4));
+    }
+  }
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "catch.hpp"
+// visrtx
+#include "gpu/upsample.h"
+// std
+#include <vector>
+
+using namespace visrtx;
+
+SCENARIO("scaledRenderSize behavior", "[upsample]")
+{
+  GIVEN("A 1920x1080 frame")
+  {
+    const uvec2 size(1920, 1080);
+
+    THEN("A scale of 1 is the identity")
+    {
+      REQUIRE(scaledRenderSize(size, 1.f) == size);
+    }
+
+    THEN("A scale of 0.5 halves both dimensions")
+    {
+      REQUIRE(scaledRenderSize(size, 0.5f) == uvec2(960, 540));
+    }
+
+    THEN("Out of range scales are clamped")
+    {
+      REQUIRE(scaledRenderSize(size, 2.f) == size);
+      REQUIRE(scaledRenderSize(uvec2(10), 0.f) == uvec2(1));
+    }
+  }
+}
+
+SCENARIO("Upsampling filters", "[upsample]")
+{
+  GIVEN("A 2x2 source image upsampled to 4x4")
+  {
+    const uvec2 srcSize(2, 2);
+    const uvec2 dstSize(4, 4);
+    const std::vector<float> src = {0.f, 1.f, 2.f, 3.f};
+
+    THEN("Corners map to the nearest source sample")
+    {
+      REQUIRE(upsampleNearestIndex(srcSize, dstSize, uvec2(0, 0)) == 0);
+      REQUIRE(upsampleNearestIndex(srcSize, dstSize, uvec2(3, 0)) == 1);
+      REQUIRE(upsampleNearestIndex(srcSize, dstSize, uvec2(0, 3)) == 2);
+      REQUIRE(upsampleNearestIndex(srcSize, dstSize, uvec2(3, 3)) == 3);
+      REQUIRE(upsampleBilinear(src.data(), srcSize, dstSize, uvec2(0, 0))
+          == Approx(0.f));
+      REQUIRE(upsampleBilinear(src.data(), srcSize, dstSize, uvec2(3, 3))
+          == Approx(3.f));
+    }
+
+    THEN("Interior pixels are interpolated")
+    {
+      REQUIRE(upsampleBilinear(src.data(), srcSize, dstSize, uvec2(1, 0))
+          == Approx(0.25f));
+      REQUIRE(upsampleBilinear(src.data(), srcSize, dstSize, uvec2(1, 1))
+          == Approx(0.75f));
+    }
+  }
+
+  GIVEN("Source and destination of the same size")
+  {
+    const uvec2 size(3, 2);
+    const std::vector<float> src = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+
+    THEN("Bilinear upsampling is the identity")
+    {
+      for (uint32_t y = 0; y < size.y; y++) {
+        for (uint32_t x = 0; x < size.x; x++) {
+          REQUIRE(upsampleBilinear(src.data(), size, size, uvec2(x, y))
+              == Approx(src[x + y * size.x]));
+        }
+      }
+    }
+  }
+
+  GIVEN("A constant color image")
+  {
+    const uvec2 srcSize(3, 3);
+    const uvec2 dstSize(7, 5);
+    const std::vector<vec4> color(9, vec4(0.25f, 0.5f, 0.75f, 1.f));
+    const std::vector<float> depth(9, 2.f);
+    const std::vector<vec3> normal(9, vec3(0.f, 0.f, 1.f));
+
+    THEN("Both filters reproduce the constant")
+    {
+      for (uint32_t y = 0; y < dstSize.y; y++) {
+        for (uint32_t x = 0; x < dstSize.x; x++) {
+          const auto b =
+              upsampleBilinear(color.data(), srcSize, dstSize, uvec2(x, y));
+          const auto e = upsampleEdgeAware(color.data(),
+              depth.data(),
+              normal.data(),
+              srcSize,
+              dstSize,
+              uvec2(x, y));
+          REQUIRE(glm::all(glm::epsilonEqual(b, color[0], 1e-5f)));
+          REQUIRE(glm::all(glm::epsilonEqual(e, color[0], 1e-5f)));
+        }
+      }
+    }
+  }
+
+  GIVEN("A depth discontinuity between a near and a far surface")
+  {
+    const uvec2 srcSize(2, 1);
+    const uvec2 dstSize(8, 1);
+    const std::vector<vec4> color = {vec4(1.f), vec4(0.f)};
+    const std::vector<float> depth = {1.f, 100.f};
+    const std::vector<vec3> normal(2, vec3(0.f, 0.f, 1.f));
+
+    THEN("Edge-aware upsampling does not bleed across the edge")
+    {
+      const uvec2 pixel(3, 0);
+      const auto b =
+          upsampleBilinear(color.data(), srcSize, dstSize, pixel);
+      const auto e = upsampleEdgeAware(
+          color.data(), depth.data(), normal.data(), srcSize, dstSize, pixel);
+      REQUIRE(b.x < 0.9f);
+      REQUIRE(e.x > 0.99f);
+    }
+  }
+}